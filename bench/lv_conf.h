@@ -0,0 +1,24 @@
+/**
+ * @file lv_conf.h
+ * @brief Minimal headless LVGL configuration of the lv_keyboard_t9_bench target.
+ *
+ * Everything not set here keeps the lv_conf_internal.h defaults.
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH 16
+
+// lv_malloc/lv_realloc/lv_free are provided by the bench to count the allocations
+#define LV_USE_STDLIB_MALLOC LV_STDLIB_CUSTOM
+#define LV_USE_STDLIB_STRING LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF LV_STDLIB_CLIB
+
+#define LV_USE_OS LV_OS_NONE
+#define LV_USE_LOG 0
+#define LV_USE_ASSERT_MALLOC 1
+
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_14
+
+#endif // LV_CONF_H
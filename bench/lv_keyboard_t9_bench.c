@@ -0,0 +1,429 @@
+/**
+ * @file lv_keyboard_t9_bench.c
+ * @brief Headless host benchmark of the T9 keyboard, from keypress to redrawn textarea.
+ *
+ * LVGL runs with a dummy display (the flush callback drops the pixels) and a virtual tick, and
+ * the keyboard receives the same events a touch press would send. Every scenario is run with
+ * textareas prefilled from 0 to 2k chars and reports per event:
+ *  - CPU time of the keyboard handler and of the following display refresh
+ *  - invalidated area (lv_keyboard_t9_get_dirty)
+ *  - lv_malloc/lv_realloc calls and bytes (the bench is the LVGL allocator, see bench/lv_conf.h)
+ * The keyboard state allocated per instance is printed first. The keyboard is warmed up with a
+ * reserved text buffer and the allocation audit of its handlers is printed after the scenarios.
+ *
+ * The replay scenario feeds an input trace (LV_KEYBOARD_T9_USE_INPUT_TRACE) in recorded time on the
+ * virtual tick: the given trace file, e.g. a session recorded on a device, or else a trace recorded
+ * from the multitap and popover scenarios. The text typed by the trace into an empty textarea is
+ * printed last, and compared with the recorded one when the bench recorded it.
+ *
+ * Usage: lv_keyboard_t9_bench [events per scenario] [trace file]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if !LV_KEYBOARD_T9_USE_DIRTY_REPORT || !LV_KEYBOARD_T9_USE_INPUT_TRACE
+#error "The bench needs LV_KEYBOARD_T9_USE_DIRTY_REPORT=1 and LV_KEYBOARD_T9_USE_INPUT_TRACE=1"
+#endif
+
+#define BENCH_HOR_RES 320
+#define BENCH_VER_RES 240
+#define BENCH_KEYBOARD_H 200
+#define BENCH_DEFAULT_EVENTS 200
+#define BENCH_TRACE_MAX (64 * 1024)
+
+// Keyboard buttonmatrix ids of the default layout (T9_LAYOUT_4X4)
+#define BENCH_BTN_1 0
+#define BENCH_BTN_ABC2 1
+#define BENCH_BTN_DEF3 2
+#define BENCH_BTN_BACKSPACE 3
+#define BENCH_BTN_CASE 12
+#define BENCH_BTN_MODE 15
+
+static const uint32_t bench_text_lengths[] = {0, 256, 1024, 2048};
+
+// Trace of the replay scenario, loaded from a file or recorded by the bench
+static uint8_t bench_trace[BENCH_TRACE_MAX];
+static uint32_t bench_trace_len;
+
+// --- Counting allocator (LV_STDLIB_CUSTOM) ---
+
+static uint32_t bench_alloc_cnt;
+static uint64_t bench_alloc_bytes;
+
+void lv_mem_init(void)
+{
+}
+
+void lv_mem_deinit(void)
+{
+}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes)
+{
+    LV_UNUSED(mem);
+    LV_UNUSED(bytes);
+    return NULL;
+}
+
+void lv_mem_remove_pool(lv_mem_pool_t pool)
+{
+    LV_UNUSED(pool);
+}
+
+void *lv_malloc_core(size_t size)
+{
+    bench_alloc_cnt++;
+    bench_alloc_bytes += size;
+    lv_keyboard_t9_alloc_audit_hook(size);
+    return malloc(size);
+}
+
+void *lv_realloc_core(void *p, size_t new_size)
+{
+    bench_alloc_cnt++;
+    bench_alloc_bytes += new_size;
+    lv_keyboard_t9_alloc_audit_hook(new_size);
+    return realloc(p, new_size);
+}
+
+void lv_free_core(void *p)
+{
+    free(p);
+}
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p)
+{
+    lv_memzero(mon_p, sizeof(*mon_p));
+}
+
+lv_result_t lv_mem_test_core(void)
+{
+    return LV_RESULT_OK;
+}
+
+// --- Headless display and virtual tick ---
+
+static uint32_t bench_tick_ms;
+static uint8_t bench_draw_buf[BENCH_HOR_RES * 40 * 2];
+
+static uint32_t bench_tick_cb(void)
+{
+    return bench_tick_ms;
+}
+
+static void bench_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(px_map);
+    lv_display_flush_ready(disp);
+}
+
+static uint64_t bench_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// --- Measurement ---
+
+typedef struct
+{
+    uint32_t events;
+    uint64_t handler_ns;
+    uint64_t handler_max_ns;
+    uint64_t render_ns;
+    uint64_t dirty_px;
+    uint64_t alloc_cnt;
+    uint64_t alloc_bytes;
+} bench_result_t;
+
+typedef struct
+{
+    lv_display_t *disp;
+    lv_obj_t *ta;
+    lv_obj_t *keyboard;
+    bench_result_t *res;
+} bench_ctx_t;
+
+typedef struct
+{
+    uint64_t t0;
+    uint32_t alloc_cnt;
+    uint64_t alloc_bytes;
+} bench_mark_t;
+
+static void bench_event_begin(bench_mark_t *mark)
+{
+    mark->alloc_cnt = bench_alloc_cnt;
+    mark->alloc_bytes = bench_alloc_bytes;
+    mark->t0 = bench_cpu_ns();
+}
+
+// The handler of the event returned: refresh the display and account the event
+static void bench_event_end(bench_ctx_t *ctx, const bench_mark_t *mark)
+{
+    bench_result_t *res = ctx->res;
+    uint64_t t0 = mark->t0;
+    uint64_t t1 = bench_cpu_ns();
+    lv_refr_now(ctx->disp);
+    uint64_t t2 = bench_cpu_ns();
+
+    lv_keyboard_t9_dirty_t dirty;
+    lv_keyboard_t9_get_dirty(ctx->keyboard, &dirty);
+
+    res->events++;
+    res->handler_ns += t1 - t0;
+    if (t1 - t0 > res->handler_max_ns)
+        res->handler_max_ns = t1 - t0;
+    res->render_ns += t2 - t1;
+    res->dirty_px += dirty.area_px;
+    res->alloc_cnt += bench_alloc_cnt - mark->alloc_cnt;
+    res->alloc_bytes += bench_alloc_bytes - mark->alloc_bytes;
+}
+
+// Send one event to a buttonmatrix as if btn_id was pressed, then refresh the display
+static void bench_send(bench_ctx_t *ctx, lv_obj_t *btnmatrix, uint32_t btn_id, lv_event_code_t code)
+{
+    bench_mark_t mark;
+    bench_event_begin(&mark);
+    lv_buttonmatrix_set_selected_button(btnmatrix, btn_id);
+    lv_obj_send_event(btnmatrix, code, &btn_id);
+    bench_event_end(ctx, &mark);
+}
+
+static void bench_press(bench_ctx_t *ctx, uint32_t btn_id, uint32_t delay_ms)
+{
+    bench_tick_ms += delay_ms;
+    bench_send(ctx, ctx->keyboard, btn_id, LV_EVENT_VALUE_CHANGED);
+}
+
+// --- Scenarios, each one sends `events` measured events ---
+
+// Cycle through "abc2" and then "def3", taps well inside the cycle timeout
+static void bench_scenario_multitap(bench_ctx_t *ctx, uint32_t events)
+{
+    for (uint32_t i = 0; i < events; i++)
+    {
+        uint32_t btn_id = (i / 8) % 2 ? BENCH_BTN_DEF3 : BENCH_BTN_ABC2;
+        bench_press(ctx, btn_id, (i % 8) == 0 ? lv_keyboard_t9_get_cycle_timeout() + 1 : 100);
+    }
+}
+
+// Alternate the case key and the mode key
+static void bench_scenario_mode(bench_ctx_t *ctx, uint32_t events)
+{
+    for (uint32_t i = 0; i < events; i++)
+        bench_press(ctx, (i % 2) ? BENCH_BTN_MODE : BENCH_BTN_CASE, 100);
+    lv_keyboard_t9_set_mode(ctx->keyboard, T9_MODE_LOWER);
+}
+
+// Tap, long-press and pick a char in the popover (three measured events)
+static void bench_scenario_popover(bench_ctx_t *ctx, uint32_t events)
+{
+    t9_keyboard_t *kb = lv_obj_get_user_data(ctx->keyboard);
+    for (uint32_t i = 0; i + 3 <= events; i += 3)
+    {
+        uint32_t btn_id = (i / 3) % 2 ? BENCH_BTN_1 : BENCH_BTN_ABC2;
+        bench_press(ctx, btn_id, lv_keyboard_t9_get_cycle_timeout() + 1);
+        bench_tick_ms += 400;
+        bench_send(ctx, ctx->keyboard, btn_id, LV_EVENT_LONG_PRESSED);
+        if (kb->popover == NULL)
+            break;
+        bench_tick_ms += 300;
+        bench_send(ctx, kb->popover, 2, LV_EVENT_VALUE_CHANGED);
+    }
+}
+
+// Backspace hold, LVGL repeats VALUE_CHANGED every 100 ms
+static void bench_scenario_backspace(bench_ctx_t *ctx, uint32_t events)
+{
+    for (uint32_t i = 0; i < events; i++)
+        bench_press(ctx, BENCH_BTN_BACKSPACE, 100);
+}
+
+// Replay the whole trace in recorded time, the timers run on the virtual tick between the events
+static void bench_scenario_replay(bench_ctx_t *ctx, uint32_t events)
+{
+    LV_UNUSED(events);
+    lv_keyboard_t9_replay_t replay;
+    if (!lv_keyboard_t9_replay_init(&replay, bench_trace, bench_trace_len))
+        return;
+    uint32_t delay;
+    while (lv_keyboard_t9_replay_peek(&replay, &delay))
+    {
+        bench_tick_ms += delay;
+        lv_timer_handler();
+        bench_mark_t mark;
+        bench_event_begin(&mark);
+        lv_keyboard_t9_replay_step(ctx->keyboard, &replay);
+        bench_event_end(ctx, &mark);
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    void (*run)(bench_ctx_t *ctx, uint32_t events);
+} bench_scenario_t;
+
+static const bench_scenario_t bench_scenarios[] = {
+    {"multitap", bench_scenario_multitap},
+    {"mode", bench_scenario_mode},
+    {"popover", bench_scenario_popover},
+    {"backspace", bench_scenario_backspace},
+    {"replay", bench_scenario_replay},
+};
+
+static void bench_fill_textarea(lv_obj_t *ta, uint32_t len)
+{
+    static char text[2048 + 1];
+    static const char words[] = "the quick brown fox jumps over the lazy dog ";
+    for (uint32_t i = 0; i < len; i++)
+        text[i] = words[i % (sizeof(words) - 1)];
+    text[len] = '\0';
+    lv_textarea_set_text(ta, text);
+    lv_textarea_set_cursor_pos(ta, LV_TEXTAREA_CURSOR_LAST);
+}
+
+static bool bench_load_trace(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return false;
+    bench_trace_len = (uint32_t)fread(bench_trace, 1, sizeof(bench_trace), f);
+    fclose(f);
+    return bench_trace_len > 0;
+}
+
+// Record the multitap and popover scenarios typing into an empty textarea, return the typed text
+static char *bench_record_trace(bench_ctx_t *ctx, uint32_t events)
+{
+    lv_textarea_set_text(ctx->ta, "");
+    lv_keyboard_t9_set_mode(ctx->keyboard, T9_MODE_LOWER);
+    bench_tick_ms += 10000;
+    lv_keyboard_t9_record_start(ctx->keyboard, bench_trace, sizeof(bench_trace));
+    bench_scenario_multitap(ctx, events);
+    bench_scenario_popover(ctx, events);
+    bench_trace_len = lv_keyboard_t9_record_stop(ctx->keyboard);
+    return strdup(lv_textarea_get_text(ctx->ta));
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t events = BENCH_DEFAULT_EVENTS;
+    if (argc > 1)
+        events = (uint32_t)strtoul(argv[1], NULL, 10);
+    if (events == 0)
+        events = BENCH_DEFAULT_EVENTS;
+    const char *trace_path = argc > 2 ? argv[2] : NULL;
+    if (trace_path && !bench_load_trace(trace_path))
+    {
+        fprintf(stderr, "could not read the trace %s\n", trace_path);
+        return 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(bench_tick_cb);
+    lv_display_t *disp = lv_display_create(BENCH_HOR_RES, BENCH_VER_RES);
+    lv_display_set_flush_cb(disp, bench_flush_cb);
+    lv_display_set_buffers(disp, bench_draw_buf, NULL, sizeof(bench_draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+    lv_obj_t *scr = lv_screen_active();
+    lv_obj_t *ta = lv_textarea_create(scr);
+    lv_obj_set_size(ta, BENCH_HOR_RES, BENCH_VER_RES - BENCH_KEYBOARD_H);
+    lv_obj_align(ta, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_t *cont = lv_obj_create(scr);
+    lv_obj_set_size(cont, BENCH_HOR_RES, BENCH_KEYBOARD_H);
+    lv_obj_align(cont, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_pad_all(cont, 0, 0);
+    lv_obj_t *keyboard = lv_keyboard_t9_init(cont, ta);
+    if (keyboard == NULL)
+    {
+        fprintf(stderr, "lv_keyboard_t9_init failed\n");
+        return 1;
+    }
+    // Heap-free hot paths: the blinking cursor animation would allocate on every cursor move
+    lv_obj_set_style_anim_duration(ta, 0, LV_PART_CURSOR);
+    lv_keyboard_t9_reserve_text(keyboard, 4096);
+    lv_keyboard_t9_warm_up(keyboard);
+    lv_refr_now(disp);
+
+    char *recorded_text = NULL;
+    if (trace_path == NULL)
+    {
+        bench_result_t res;
+        bench_ctx_t ctx = {disp, ta, keyboard, &res};
+        recorded_text = bench_record_trace(&ctx, events);
+    }
+
+    printf("keyboard state: %u bytes per instance\n", (unsigned)sizeof(t9_keyboard_t));
+    printf("%-10s %6s %6s %10s %10s %10s %10s %8s %10s\n", "scenario", "text", "events", "handler_us",
+           "max_us", "render_us", "dirty_px", "allocs", "alloc_B");
+    for (size_t s = 0; s < sizeof(bench_scenarios) / sizeof(bench_scenarios[0]); s++)
+    {
+        for (size_t l = 0; l < sizeof(bench_text_lengths) / sizeof(bench_text_lengths[0]); l++)
+        {
+            bench_result_t res;
+            memset(&res, 0, sizeof(res));
+            bench_ctx_t ctx = {disp, ta, keyboard, &res};
+
+            bench_fill_textarea(ta, bench_text_lengths[l]);
+            bench_tick_ms += 10000; // Nothing left cycling from the previous run
+            lv_refr_now(disp);
+            bench_scenarios[s].run(&ctx, events);
+
+            uint32_t n = res.events ? res.events : 1;
+            printf("%-10s %6u %6u %10.1f %10.1f %10.1f %10llu %8.2f %10.1f\n", bench_scenarios[s].name,
+                   (unsigned)bench_text_lengths[l], (unsigned)res.events, res.handler_ns / 1000.0 / n,
+                   res.handler_max_ns / 1000.0, res.render_ns / 1000.0 / n,
+                   (unsigned long long)(res.dirty_px / n), (double)res.alloc_cnt / n,
+                   (double)res.alloc_bytes / n);
+        }
+    }
+
+    // Text typed by the trace, replayed as fast as possible (the presses keep their recorded times)
+    lv_textarea_set_text(ta, "");
+    lv_keyboard_t9_set_mode(keyboard, T9_MODE_LOWER);
+    bench_tick_ms += 10000;
+    lv_keyboard_t9_replay_t replay;
+    int ret = 0;
+    if (lv_keyboard_t9_replay_init(&replay, bench_trace, bench_trace_len))
+    {
+        while (lv_keyboard_t9_replay_step(keyboard, &replay))
+        {
+        }
+        const char *text = lv_textarea_get_text(ta);
+        printf("replay: %u events, %u mode resyncs, %u bytes of text\n", (unsigned)replay.events,
+               (unsigned)replay.resyncs, (unsigned)strlen(text));
+        printf("replay text: %s\n", text);
+        if (recorded_text)
+        {
+            bool same = strcmp(text, recorded_text) == 0;
+            printf("replay check: %s\n", same ? "ok" : "MISMATCH");
+            ret = same ? 0 : 1;
+        }
+    }
+    else
+    {
+        fprintf(stderr, "not a T9 input trace\n");
+        ret = 1;
+    }
+    free(recorded_text);
+
+    lv_keyboard_t9_alloc_audit_t audit;
+    lv_keyboard_t9_get_alloc_audit(keyboard, &audit);
+    printf("alloc audit: %u handlers, %u allocated (%u allocations, %u bytes), last trace id %u\n",
+           (unsigned)audit.handlers, (unsigned)audit.alloc_handlers, (unsigned)audit.alloc_cnt,
+           (unsigned)audit.alloc_bytes, (unsigned)audit.last_trace);
+
+    lv_deinit();
+    return ret;
+}
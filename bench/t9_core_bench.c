@@ -0,0 +1,170 @@
+/**
+ * @file t9_core_bench.c
+ * @brief Host micro-benchmark of the LVGL independent multi-tap core (t9_core).
+ *
+ * The core is fed key events with their times and its edits are applied to a fixed char buffer,
+ * like a serial console would. Every scenario reports the average CPU time per event and the
+ * event rate, for the core alone and for the core plus the buffer edits. The text typed by the
+ * "hello" scenario is printed and checked.
+ *
+ * Usage: t9_core_bench [events per scenario]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "t9_core.h"
+
+#define BENCH_DEFAULT_EVENTS 10000000
+#define BENCH_TEXT_MAX 256
+
+// Text edited by the core, the buffer restarts when full
+typedef struct
+{
+    char buf[BENCH_TEXT_MAX];
+    uint32_t len; // Bytes
+} bench_text_t;
+
+typedef struct
+{
+    uint32_t key;
+    uint32_t dt; // ms since the previous event
+} bench_event_t;
+
+// "hello" in lower case multi-tap: h = 4 x2, e = 3 x2, l = 5 x3, pause, l = 5 x3, o = 6 x3
+static const bench_event_t bench_hello[] = {
+    {T9_CORE_KEY_4, 2000}, {T9_CORE_KEY_4, 100}, {T9_CORE_KEY_3, 200}, {T9_CORE_KEY_3, 100},
+    {T9_CORE_KEY_5, 200}, {T9_CORE_KEY_5, 100}, {T9_CORE_KEY_5, 100}, {T9_CORE_KEY_5, 2000},
+    {T9_CORE_KEY_5, 100}, {T9_CORE_KEY_5, 100}, {T9_CORE_KEY_6, 200}, {T9_CORE_KEY_6, 100},
+    {T9_CORE_KEY_6, 100}, {T9_CORE_KEY_SPACE, 200},
+};
+
+static uint64_t bench_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Length in bytes of the UTF-8 char ending at len
+static uint32_t bench_last_char_len(const bench_text_t *text)
+{
+    uint32_t i = text->len;
+    while (i > 0 && (text->buf[i - 1] & 0xC0) == 0x80)
+        i--;
+    return i > 0 ? text->len - i + 1 : 0;
+}
+
+static void bench_apply(bench_text_t *text, const t9_edit_t *edit)
+{
+    uint32_t n;
+    switch (edit->type)
+    {
+    case T9_EDIT_REPLACE_LAST:
+        text->len -= bench_last_char_len(text);
+        // fall through
+    case T9_EDIT_INSERT:
+        n = (uint32_t)strlen(edit->text);
+        if (text->len + n >= BENCH_TEXT_MAX)
+            text->len = 0;
+        memcpy(&text->buf[text->len], edit->text, n);
+        text->len += n;
+        break;
+    case T9_EDIT_DELETE:
+        for (n = 0; n < edit->cnt; n++)
+            text->len -= bench_last_char_len(text);
+        break;
+    default:
+        break;
+    }
+    text->buf[text->len] = '\0';
+}
+
+// Random keys at random intervals: about one in three presses cycles, with helper keys in between
+static void bench_make_random(bench_event_t *events, uint32_t cnt)
+{
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 16;
+        if (r % 16 == 0)
+            events[i].key = T9_CORE_KEY_BACKSPACE + (r >> 4) % 7; // Helper keys
+        else if (i > 0 && r % 3 == 0)
+            events[i].key = events[i - 1].key; // Same key, cycles if soon enough
+        else
+            events[i].key = (r >> 4) % 10;
+        events[i].dt = 50 + (r >> 8) % 1500;
+    }
+}
+
+static void bench_run(const char *name, const bench_event_t *events, uint32_t cnt, uint32_t total)
+{
+    t9_core_t core;
+    t9_edit_t edits[T9_CORE_EDITS_MAX];
+    uint32_t edit_cnt = 0;
+
+    // Core only
+    t9_core_init(&core, NULL, 1000);
+    uint32_t now = 0;
+    uint64_t start = bench_cpu_ns();
+    for (uint32_t i = 0; i < total; i++)
+    {
+        const bench_event_t *ev = &events[i % cnt];
+        now += ev->dt;
+        edit_cnt += t9_core_press(&core, ev->key, now, edits, T9_CORE_EDITS_MAX);
+    }
+    uint64_t core_ns = bench_cpu_ns() - start;
+
+    // Core and text edits
+    static bench_text_t text;
+    text.len = 0;
+    t9_core_init(&core, NULL, 1000);
+    now = 0;
+    start = bench_cpu_ns();
+    for (uint32_t i = 0; i < total; i++)
+    {
+        const bench_event_t *ev = &events[i % cnt];
+        now += ev->dt;
+        uint32_t n = t9_core_press(&core, ev->key, now, edits, T9_CORE_EDITS_MAX);
+        for (uint32_t e = 0; e < n; e++)
+            bench_apply(&text, &edits[e]);
+    }
+    uint64_t text_ns = bench_cpu_ns() - start;
+
+    printf("%-8s %10u events %8.1f ns/event %8.2f M events/s   with text %8.1f ns/event %8.2f M events/s   (%u edits)\n",
+           name, (unsigned)total, (double)core_ns / total, total * 1e3 / (double)(core_ns ? core_ns : 1),
+           (double)text_ns / total, total * 1e3 / (double)(text_ns ? text_ns : 1), (unsigned)edit_cnt);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t events = BENCH_DEFAULT_EVENTS;
+    if (argc > 1)
+        events = (uint32_t)strtoul(argv[1], NULL, 10);
+    if (events == 0)
+        events = BENCH_DEFAULT_EVENTS;
+
+    static bench_event_t random_events[4096];
+    bench_make_random(random_events, sizeof(random_events) / sizeof(random_events[0]));
+    bench_run("random", random_events, sizeof(random_events) / sizeof(random_events[0]), events);
+    bench_run("hello", bench_hello, sizeof(bench_hello) / sizeof(bench_hello[0]), events);
+
+    // What the hello scenario types once
+    t9_core_t core;
+    t9_edit_t edits[T9_CORE_EDITS_MAX];
+    static bench_text_t text;
+    t9_core_init(&core, NULL, 1000);
+    uint32_t now = 0;
+    for (uint32_t i = 0; i < sizeof(bench_hello) / sizeof(bench_hello[0]); i++)
+    {
+        now += bench_hello[i].dt;
+        uint32_t n = t9_core_press(&core, bench_hello[i].key, now, edits, T9_CORE_EDITS_MAX);
+        for (uint32_t e = 0; e < n; e++)
+            bench_apply(&text, &edits[e]);
+    }
+    printf("hello typed: \"%s\"\n", text.buf);
+    return strcmp(text.buf, "hello ") == 0 ? 0 : 1;
+}
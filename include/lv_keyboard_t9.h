@@ -1,10 +1,108 @@
 #ifndef LV_KEYBOARD_T9_H
 #define LV_KEYBOARD_T9_H
 
+#include "t9_core.h" // Multi-tap engine, modes and charset packs
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Minimal RAM profile: the optional features below default to off and only one popover object is
+// kept per keyboard. Anything defined explicitly still wins over the profile.
+#ifndef LV_KEYBOARD_T9_PROFILE_MINIMAL
+#define LV_KEYBOARD_T9_PROFILE_MINIMAL 0
+#endif
+
+// Predictive mode: dictionary, learned words and candidate bar (per keyboard state and one object)
+#ifndef LV_KEYBOARD_T9_USE_PREDICTIVE
+#if LV_KEYBOARD_T9_PROFILE_MINIMAL
+#define LV_KEYBOARD_T9_USE_PREDICTIVE 0
+#else
+#define LV_KEYBOARD_T9_USE_PREDICTIVE 1
+#endif
+#endif
+
+// Physical keypad input (lv_keyboard_t9_feed_key, lv_keyboard_t9_create_keypad)
+#ifndef LV_KEYBOARD_T9_USE_KEYPAD
+#if LV_KEYBOARD_T9_PROFILE_MINIMAL
+#define LV_KEYBOARD_T9_USE_KEYPAD 0
+#else
+#define LV_KEYBOARD_T9_USE_KEYPAD 1
+#endif
+#endif
+
+// Report the area invalidated by each keyboard operation (see lv_keyboard_t9_get_dirty)
+#ifndef LV_KEYBOARD_T9_USE_DIRTY_REPORT
+#define LV_KEYBOARD_T9_USE_DIRTY_REPORT 0
+#endif
+
+// Count presses, commits, redraw work and handler times (see lv_keyboard_t9_get_stats)
+#ifndef LV_KEYBOARD_T9_USE_STATS
+#define LV_KEYBOARD_T9_USE_STATS 0
+#endif
+
+// Rank the predictive candidates on a worker (FreeRTOS task on ESP-IDF, pthread elsewhere), the press
+// only walks the trie and the candidates fill in once ranked. The worker calls lv_async_call under
+// lv_lock(), so LVGL needs LV_USE_OS, or define LV_KEYBOARD_T9_RANK_LOCK()/UNLOCK() to the app mutex.
+#ifndef LV_KEYBOARD_T9_USE_ASYNC_RANK
+#define LV_KEYBOARD_T9_USE_ASYNC_RANK 0
+#endif
+
+// Record the keyboard inputs to a compact binary trace and replay it through the same handlers
+// (see lv_keyboard_t9_record_start and lv_keyboard_t9_replay_step)
+#ifndef LV_KEYBOARD_T9_USE_INPUT_TRACE
+#define LV_KEYBOARD_T9_USE_INPUT_TRACE 0
+#endif
+
+// Let other tasks control the keyboards through a lock-free queue drained by an lv_timer
+// (see lv_keyboard_t9_post_set_mode), instead of taking the LVGL mutex
+#ifndef LV_KEYBOARD_T9_USE_CMD_QUEUE
+#define LV_KEYBOARD_T9_USE_CMD_QUEUE 0
+#endif
+
+// Render the idle keys once per mode into cached images (needs LV_USE_SNAPSHOT), a redraw then blits
+// the image and only draws the pressed or selected key. Costs T9_KEY_CACHE_SLOTS images of the matrix size.
+#ifndef LV_KEYBOARD_T9_USE_KEY_CACHE
+#define LV_KEYBOARD_T9_USE_KEY_CACHE 0
+#endif
+
+// Count the lv_malloc / lv_realloc calls made inside the keyboard handlers, reported by the allocator
+// of the application through lv_keyboard_t9_alloc_audit_hook (see lv_keyboard_t9_get_alloc_audit)
+#ifndef LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+#define LV_KEYBOARD_T9_USE_ALLOC_AUDIT 0
+#endif
+
+// Trace hooks around the hot paths, empty by default. Define both to forward the
+// lv_keyboard_t9_trace_t points to a tracer (e.g. SEGGER SystemView user markers).
+#ifndef LV_KEYBOARD_T9_TRACE_BEGIN
+#define LV_KEYBOARD_T9_TRACE_BEGIN(id)
+#endif
+#ifndef LV_KEYBOARD_T9_TRACE_END
+#define LV_KEYBOARD_T9_TRACE_END(id)
+#endif
+
+// Trace points given to LV_KEYBOARD_T9_TRACE_BEGIN/END
+typedef enum
+{
+    LV_KEYBOARD_T9_TRACE_PRESS,     // Key press handling
+    LV_KEYBOARD_T9_TRACE_LONGPRESS, // Long-press handling, popover build included
+    LV_KEYBOARD_T9_TRACE_POPOVER,   // Popover / candidate bar selection
+    LV_KEYBOARD_T9_TRACE_LABELS,    // Keyboard map update
+    LV_KEYBOARD_T9_TRACE_TEXT,      // Textarea mutation
+    LV_KEYBOARD_T9_TRACE_RANK       // Asynchronous ranking result applied
+} lv_keyboard_t9_trace_t;
+
+// Keyboard operations of an input trace, each record also has the button, the time since the
+// previous record and the mode of the keyboard
+typedef enum
+{
+    LV_KEYBOARD_T9_INPUT_PRESS,         // Keyboard matrix button (touch VALUE_CHANGED or keypad key)
+    LV_KEYBOARD_T9_INPUT_LONGPRESS,     // Keyboard matrix long-press
+    LV_KEYBOARD_T9_INPUT_POPOVER,       // Button of the open popover
+    LV_KEYBOARD_T9_INPUT_CANDIDATE,     // Button of the predictive candidate bar
+    LV_KEYBOARD_T9_INPUT_POPOVER_CLOSE, // Popover closed without a choice (keypad)
+    LV_KEYBOARD_T9_INPUT_COUNT
+} lv_keyboard_t9_input_t;
 
 // Event types for T9 keyboard
 typedef enum {
@@ -12,16 +110,121 @@ typedef enum {
 	LV_KEYBOARD_T9_EVENT_CANCEL = 1   // Close button pressed
 } lv_keyboard_t9_event_t;
 
+// Keys of a physical keypad, see lv_keyboard_t9_feed_key (the keys of the core)
 typedef enum
 {
-    T9_MODE_LOWER,
-    T9_MODE_UPPER,
-    T9_MODE_NUMBERS
-} t9_mode_t;
+    LV_KEYBOARD_T9_KEY_1 = T9_CORE_KEY_1,
+    LV_KEYBOARD_T9_KEY_2 = T9_CORE_KEY_2,
+    LV_KEYBOARD_T9_KEY_3 = T9_CORE_KEY_3,
+    LV_KEYBOARD_T9_KEY_4 = T9_CORE_KEY_4,
+    LV_KEYBOARD_T9_KEY_5 = T9_CORE_KEY_5,
+    LV_KEYBOARD_T9_KEY_6 = T9_CORE_KEY_6,
+    LV_KEYBOARD_T9_KEY_7 = T9_CORE_KEY_7,
+    LV_KEYBOARD_T9_KEY_8 = T9_CORE_KEY_8,
+    LV_KEYBOARD_T9_KEY_9 = T9_CORE_KEY_9,
+    LV_KEYBOARD_T9_KEY_0 = T9_CORE_KEY_0,
+    LV_KEYBOARD_T9_KEY_BACKSPACE = T9_CORE_KEY_BACKSPACE,
+    LV_KEYBOARD_T9_KEY_OK = T9_CORE_KEY_OK,
+    LV_KEYBOARD_T9_KEY_CLOSE = T9_CORE_KEY_CLOSE,
+    LV_KEYBOARD_T9_KEY_SPACE = T9_CORE_KEY_SPACE,
+    LV_KEYBOARD_T9_KEY_CASE = T9_CORE_KEY_CASE, // '*' on a 12-key keypad
+    LV_KEYBOARD_T9_KEY_MODE = T9_CORE_KEY_MODE, // '#' on a 12-key keypad
+    LV_KEYBOARD_T9_KEY_SHIFT = T9_CORE_KEY_SHIFT, // One-shot upper case, only in lv_keyboard_t9_layout_5col
+    LV_KEYBOARD_T9_KEY_COUNT = T9_CORE_KEY_COUNT
+} lv_keyboard_t9_key_t;
+
+// Keypad scan callback of lv_keyboard_t9_create_keypad: return true while a key is pressed and
+// set key to its code, the LV_KEY_* code (LV_KEY_BACKSPACE, LV_KEY_ENTER, LV_KEY_ESC) or the ASCII
+// char ('0'..'9', ' ', '*', '#')
+typedef bool (*lv_keyboard_t9_keypad_read_cb_t)(lv_obj_t *keyboard, uint32_t *key);
+
+// Opaque dictionary used by the predictive mode
+typedef struct _t9_dict_t t9_dict_t;
+
+// Opaque user-learned words, ranked by confirmations, shared by any number of keyboards
+typedef struct _t9_learn_t t9_learn_t;
+
+// Opaque keyboard shared by a set of textareas, built on the first focus (lv_keyboard_t9_shared_create)
+typedef struct _t9_shared_t t9_shared_t;
+
+// Opaque keyboard layout (button grid and labels), see lv_keyboard_t9_set_layout
+typedef struct _t9_layout_t t9_layout_t;
+
+// Built-in layouts, const tables in flash
+extern const t9_layout_t lv_keyboard_t9_layout_4x4;   // Default: 4x4 grid, helpers on the right and bottom
+extern const t9_layout_t lv_keyboard_t9_layout_phone; // 3x4 phone keypad with a helper row, narrow screens
+extern const t9_layout_t lv_keyboard_t9_layout_5col;  // 5 columns with a one-shot shift key
+
+/**
+ * Storage of the learned words log, implemented by the application (raw flash partition, NVS blob,
+ * file...). The log is only appended to, and erased when it is compacted.
+ */
+typedef struct
+{
+    void *ctx;         // Given back to the callbacks
+    uint32_t capacity; // Log size limit in bytes, the log is compacted instead of growing past it
+    // Read up to len bytes at offset, return the bytes read (fewer at the end of the data)
+    uint32_t (*read)(void *ctx, uint32_t offset, void *buf, uint32_t len);
+    // Write len bytes at offset, which is always the current end of the log
+    bool (*append)(void *ctx, uint32_t offset, const void *data, uint32_t len);
+    // Erase the whole log
+    bool (*erase)(void *ctx);
+} lv_keyboard_t9_learn_io_t;
+
+// Invalidated area of the last keyboard operation
+typedef struct
+{
+    uint32_t op_id;    // Increments with every keyboard operation
+    uint32_t area_cnt; // Number of invalidated areas
+    uint32_t area_px;  // Sum of the invalidated areas in pixels (overlaps counted twice)
+    lv_area_t bbox;    // Bounding box of the invalidated areas
+} lv_keyboard_t9_dirty_t;
+
+// Charset pack of the letter modes, see t9_charset_t
+typedef t9_charset_t lv_keyboard_t9_charset_t;
+
+// Styles of the keyboard objects (LV_PART_MAIN), added by reference with lv_obj_add_style so one
+// style serves every keyboard. A NULL member leaves that object with the LVGL theme only.
+typedef struct
+{
+    const lv_style_t *matrix;  // Keyboard buttonmatrix
+    const lv_style_t *popover; // Long-press popovers
+    const lv_style_t *bar;     // Predictive candidate bar
+    const lv_style_t *preedit; // Composition buffer label
+} lv_keyboard_t9_theme_t;
+
+// Runtime counters of a keyboard since creation or the last lv_keyboard_t9_reset_stats
+typedef struct
+{
+    uint32_t presses;          // Key presses handled
+    uint32_t cycles;           // Multi-tap presses that replaced the previous char
+    uint32_t commits;          // Composition buffer chars and predictive words committed
+    uint32_t popovers;         // Long-press popovers opened
+    uint32_t map_rebuilds;     // Buttonmatrix map changes (key labels, popover, candidate bar)
+    uint32_t text_mutations;   // Textarea edits done by the keyboard
+    uint32_t key_cache_builds; // Idle key images rendered (LV_KEYBOARD_T9_USE_KEY_CACHE)
+    uint32_t handler_cnt;      // Event handler runs (press, long-press, popover and candidate selection)
+    uint32_t handler_max_us;
+    uint32_t handler_avg_us;
+} lv_keyboard_t9_stats_t;
+
+// Allocations inside the keyboard handlers since creation or the last lv_keyboard_t9_reset_alloc_audit
+typedef struct
+{
+    uint32_t handlers;       // Handler runs audited (press, long-press, popover and candidate selection, commit timer)
+    uint32_t alloc_handlers; // Runs that allocated
+    uint32_t alloc_cnt;      // lv_malloc / lv_realloc calls inside the handlers
+    uint32_t alloc_bytes;
+    uint8_t last_trace;      // lv_keyboard_t9_trace_t of the last run that allocated
+    bool warm;               // lv_keyboard_t9_warm_up was called, an allocation is then a violation
+} lv_keyboard_t9_alloc_audit_t;
 
 // Callback type for T9 keyboard events
 typedef void (*lv_keyboard_t9_event_cb_t)(lv_obj_t *keyboard, lv_keyboard_t9_event_t event);
 
+// Called once the shared keyboard is built, to configure it (event callback, mode, dictionary...)
+typedef void (*lv_keyboard_t9_shared_init_cb_t)(lv_obj_t *keyboard, void *user_data);
+
 // Register a callback for keyboard events
 void lv_keyboard_t9_set_event_cb(lv_obj_t *keyboard, lv_keyboard_t9_event_cb_t cb);
 
@@ -34,6 +237,13 @@ void lv_keyboard_t9_set_textarea(lv_obj_t *keyboard, lv_obj_t *ta);
 // Get the currently linked textarea of the T9 keyboard.
 lv_obj_t *lv_keyboard_t9_get_textarea(lv_obj_t *keyboard);
 
+// Insert len bytes of UTF-8 text at the cursor of the linked textarea in one edit (one relayout and
+// redraw), together with the pending char, and commit the predictive word. The next tap starts a new cycle.
+void lv_keyboard_t9_insert_text(lv_obj_t *keyboard, const char *utf8, size_t len);
+
+// Change the button layout (NULL restores lv_keyboard_t9_layout_4x4). The layout is referenced, not copied.
+void lv_keyboard_t9_set_layout(lv_obj_t *keyboard, const t9_layout_t *layout);
+
 // Set the input mode of the T9 keyboard (lowercase, uppercase, numbers).
 void lv_keyboard_t9_set_mode(lv_obj_t *keyboard, t9_mode_t mode);
 
@@ -46,6 +256,192 @@ void lv_keyboard_t9_set_cycle_timeout(uint32_t ms);
 // Get the current T9 key cycle timeout in milliseconds
 uint32_t lv_keyboard_t9_get_cycle_timeout(void);
 
+// Learn the cycle timeout of this keyboard from the user's same-key tap intervals (EWMA, no allocation),
+// kept within min_ms..max_ms. max_ms 0 goes back to the global timeout.
+void lv_keyboard_t9_set_adaptive_timeout(lv_obj_t *keyboard, uint32_t min_ms, uint32_t max_ms);
+
+// Get the cycle timeout used by this keyboard, adaptive or global, in milliseconds
+uint32_t lv_keyboard_t9_get_effective_timeout(lv_obj_t *keyboard);
+
+// Accelerate a held backspace: after word_ms each repeat deletes a word instead of a char (0: chars only),
+// after clear_ms the textarea is cleared at once (0: never). Defaults: T9_BACKSPACE_WORD_MS, T9_BACKSPACE_CLEAR_MS.
+void lv_keyboard_t9_set_backspace_accel(lv_obj_t *keyboard, uint32_t word_ms, uint32_t clear_ms);
+
+// Keep the cycled character in a preedit label and write it to the textarea only on commit
+// (cycle timeout, another key, space/OK...). Disabled by default.
+void lv_keyboard_t9_set_compose_mode(lv_obj_t *keyboard, bool en);
+
+// Set the charset pack used by the letter modes (NULL restores lv_keyboard_t9_charset_default).
+// The pack is referenced, not copied.
+void lv_keyboard_t9_set_charset(lv_obj_t *keyboard, const lv_keyboard_t9_charset_t *charset);
+
+// Get the built-in theme, its static styles are initialized on first use and shared by all keyboards
+const lv_keyboard_t9_theme_t *lv_keyboard_t9_get_default_theme(void);
+
+// Style the keyboard objects with another theme (NULL restores the built-in one). The theme and
+// its styles are referenced, not copied, they must stay valid while the keyboard uses them.
+void lv_keyboard_t9_set_theme(lv_obj_t *keyboard, const lv_keyboard_t9_theme_t *theme);
+
+// Get the area invalidated on the display since the start of the last keyboard operation
+// (needs LV_KEYBOARD_T9_USE_DIRTY_REPORT)
+void lv_keyboard_t9_get_dirty(lv_obj_t *keyboard, lv_keyboard_t9_dirty_t *dirty);
+
+#if LV_KEYBOARD_T9_USE_KEYPAD
+// Feed a physical key event, it drives the same cycling and long-press logic as the touch input.
+// Report the key as pressed again while it is held (e.g. from every keypad poll): long-press and
+// backspace repeat are detected from the timestamps (ms, e.g. lv_tick_get()).
+// While a popover is open, the digit keys pick its first ten chars and the other keys close it.
+void lv_keyboard_t9_feed_key(lv_obj_t *keyboard, lv_keyboard_t9_key_t key, bool pressed, uint32_t timestamp);
+
+// Create an LV_INDEV_TYPE_KEYPAD input device polling read_cb and feeding the keyboard.
+// It has no group, so LVGL itself ignores its keys. Deleted together with the keyboard.
+lv_indev_t *lv_keyboard_t9_create_keypad(lv_obj_t *keyboard, lv_keyboard_t9_keypad_read_cb_t read_cb);
+#endif
+
+// Share one keyboard between textareas: it is built in parent on the first LV_EVENT_FOCUSED of a
+// registered textarea, linked to every focused one and hidden (with parent) on LV_EVENT_DEFOCUSED.
+// parent is hidden until then, and the shared state is freed together with it.
+t9_shared_t *lv_keyboard_t9_shared_create(lv_obj_t *parent, lv_keyboard_t9_shared_init_cb_t init_cb,
+                                          void *user_data);
+
+// Register a textarea with the shared keyboard, it is unregistered when deleted
+void lv_keyboard_t9_shared_add_textarea(t9_shared_t *shared, lv_obj_t *ta);
+
+// Unregister a textarea, the keyboard is hidden if it was linked to it
+void lv_keyboard_t9_shared_remove_textarea(t9_shared_t *shared, lv_obj_t *ta);
+
+// Register the textareas currently in a group (the ones added to the group later are not)
+void lv_keyboard_t9_shared_add_group(t9_shared_t *shared, lv_group_t *group);
+
+// Build the shared keyboard now, still hidden, linked to the first registered textarea.
+// Returns the keyboard, NULL if no textarea is registered.
+lv_obj_t *lv_keyboard_t9_prewarm(t9_shared_t *shared);
+
+// Get the shared keyboard, NULL until it is built
+lv_obj_t *lv_keyboard_t9_shared_get_keyboard(t9_shared_t *shared);
+
+#if LV_KEYBOARD_T9_USE_INPUT_TRACE
+// Cursor of a trace being replayed, set up by lv_keyboard_t9_replay_init
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t len;
+    uint32_t pos;      // Offset of the next record
+    uint32_t time;     // Virtual time of the last replayed record in ms, 0 at the first one
+    uint32_t events;   // Records replayed
+    uint32_t resyncs;  // Records whose mode differed, set with lv_keyboard_t9_set_mode before replaying
+} lv_keyboard_t9_replay_t;
+
+// Start recording the inputs of the keyboard to buf (a previous recording is stopped). Recording
+// stops by itself when buf is full, the trace then ends at the last whole record.
+bool lv_keyboard_t9_record_start(lv_obj_t *keyboard, uint8_t *buf, uint32_t size);
+
+// Stop recording, return the trace size in bytes
+uint32_t lv_keyboard_t9_record_stop(lv_obj_t *keyboard);
+
+// Check the trace header and point the cursor at the first record (the trace is referenced, not copied)
+bool lv_keyboard_t9_replay_init(lv_keyboard_t9_replay_t *replay, const uint8_t *data, uint32_t len);
+
+// Get the recorded time between the last replayed record and the next one, false at the end.
+// Advance a virtual tick by it (and run lv_timer_handler) before the step to replay in recorded time.
+bool lv_keyboard_t9_replay_peek(const lv_keyboard_t9_replay_t *replay, uint32_t *delay_ms);
+
+// Replay the next record through the keyboard handlers, with its recorded time for the multi-tap
+// timeout. Return false at the end of the trace or on a corrupt record.
+bool lv_keyboard_t9_replay_step(lv_obj_t *keyboard, lv_keyboard_t9_replay_t *replay);
+#endif
+
+#if LV_KEYBOARD_T9_USE_CMD_QUEUE
+// Thread-safe variants of lv_keyboard_t9_set_mode / set_textarea / insert_text, callable from any task
+// (and from ISRs, they never block). The command is queued and run by the LVGL task at its next drain,
+// every T9_CMD_PERIOD_MS; the commands of one drain are coalesced per keyboard (last mode and textarea
+// win, consecutive texts are inserted at once). They return false if the queue is full, nothing is posted.
+bool lv_keyboard_t9_post_set_mode(lv_obj_t *keyboard, t9_mode_t mode);
+bool lv_keyboard_t9_post_set_textarea(lv_obj_t *keyboard, lv_obj_t *ta);
+bool lv_keyboard_t9_post_insert_text(lv_obj_t *keyboard, const char *utf8, size_t len);
+#endif
+
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+// Render the idle key images again, needed after styling the keyboard matrix directly (the keyboard
+// already does it on mode, charset, layout, theme and size changes)
+void lv_keyboard_t9_invalidate_key_cache(lv_obj_t *keyboard);
+#endif
+
+// Get the runtime counters of the keyboard (needs LV_KEYBOARD_T9_USE_STATS)
+void lv_keyboard_t9_get_stats(lv_obj_t *keyboard, lv_keyboard_t9_stats_t *stats);
+
+// Restart the runtime counters from zero
+void lv_keyboard_t9_reset_stats(lv_obj_t *keyboard);
+
+// Get the allocations made inside the handlers of the keyboard (needs LV_KEYBOARD_T9_USE_ALLOC_AUDIT)
+void lv_keyboard_t9_get_alloc_audit(lv_obj_t *keyboard, lv_keyboard_t9_alloc_audit_t *audit);
+
+// Restart the allocation audit from zero, the warm flag is kept
+void lv_keyboard_t9_reset_alloc_audit(lv_obj_t *keyboard);
+
+// Report an lv_malloc / lv_realloc to the audit, called by the allocator of the application
+// (LV_STDLIB_CUSTOM lv_malloc_core / lv_realloc_core, or a linker --wrap). No-op without the audit.
+void lv_keyboard_t9_alloc_audit_hook(size_t size);
+
+// Create now what the hot paths would otherwise create on first use: a popover for every button count
+// of the charset (up to T9_POPOVER_CACHE_SIZE) and the text buffer kept by lv_keyboard_t9_reserve_text.
+// Presses, cycles, mode toggles and popovers of a warmed keyboard do not allocate.
+void lv_keyboard_t9_warm_up(lv_obj_t *keyboard);
+
+// Keep the text of the linked textareas in a buffer of capacity bytes owned by the keyboard, edited in
+// place, instead of the label text LVGL reallocates on every edit (0 frees it). Returns false if out of memory.
+bool lv_keyboard_t9_reserve_text(lv_obj_t *keyboard, uint32_t capacity);
+
+// Replace the character before the cursor of a textarea with txt (one UTF-8 character),
+// in place when both have the same encoded size.
+void lv_keyboard_t9_textarea_replace_char(lv_obj_t *ta, const char *txt);
+
+// Delete cnt characters before the cursor of a textarea with a single label update.
+void lv_keyboard_t9_textarea_delete_chars(lv_obj_t *ta, uint32_t cnt);
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+// Build a predictive dictionary from a word list (words are referenced, not copied).
+// freqs is optional, if NULL the list is expected to be sorted from most to least frequent.
+t9_dict_t *lv_keyboard_t9_dict_create(const char *const *words, const uint16_t *freqs, uint32_t count);
+
+// Open a packed dictionary (tools/t9_dict_gen.py) in place, e.g. linked into flash: nothing is parsed
+// nor copied, data (4-byte aligned) must outlive the dictionary. NULL if data is not a packed dictionary.
+t9_dict_t *lv_keyboard_t9_dict_open(const void *data, uint32_t size);
+
+#if defined(ESP_PLATFORM)
+// Map the packed dictionary stored in the data partition with this label and open it in place
+t9_dict_t *lv_keyboard_t9_dict_open_partition(const char *label);
+#elif defined(__unix__) || defined(__APPLE__)
+// Map a packed dictionary file read-only and open it in place (host builds)
+t9_dict_t *lv_keyboard_t9_dict_open_file(const char *path);
+#endif
+
+// Free a dictionary created with lv_keyboard_t9_dict_create or opened, its mapping is released too
+void lv_keyboard_t9_dict_delete(t9_dict_t *dict);
+
+// Set the dictionary used in T9_MODE_PREDICTIVE (NULL disables the predictive mode)
+void lv_keyboard_t9_set_dictionary(lv_obj_t *keyboard, const t9_dict_t *dict);
+
+// Create the learned words, replaying the log of io (NULL to keep them in RAM only).
+// budget_bytes bounds the RAM used by the words, the least confirmed ones are forgotten first.
+t9_learn_t *lv_keyboard_t9_learn_create(uint32_t budget_bytes, const lv_keyboard_t9_learn_io_t *io);
+
+// Flush and free the learned words, they must not be linked to any keyboard anymore
+void lv_keyboard_t9_learn_delete(t9_learn_t *learn);
+
+// Learn the ASCII words of a text, e.g. a confirmed textarea (done on LV_KEYBOARD_T9_EVENT_READY)
+void lv_keyboard_t9_learn_text(t9_learn_t *learn, const char *text);
+
+// Append the buffered words to the log now (also done after T9_LEARN_FLUSH_MS idle)
+bool lv_keyboard_t9_learn_flush(t9_learn_t *learn);
+
+// Rewrite the log with one record per learned word
+bool lv_keyboard_t9_learn_compact(t9_learn_t *learn);
+
+// Rank the learned words first in the predictive mode and learn the text confirmed with OK (NULL disables)
+void lv_keyboard_t9_set_learn(lv_obj_t *keyboard, t9_learn_t *learn);
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,188 @@
+/**
+ * @file t9_core.h
+ * @brief LVGL independent T9 multi-tap engine: key and time events in, text edits out.
+ *
+ * The core keeps the multi-tap state of one input (mode, one-shot shift, last key, cycle index,
+ * adaptive timeout) and turns every key press into edits of the text before the cursor, written
+ * to a caller buffer. It includes no LVGL header and never allocates: a t9_core_t is a plain struct
+ * and the inserted texts point into the const charset pack. lv_keyboard_t9 is an adapter that
+ * applies the edits to its textarea; a serial console or a benchmark uses the core directly.
+ */
+#ifndef T9_CORE_H
+#define T9_CORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define T9_CORE_EDITS_MAX 1 // Most edits a single press emits
+
+typedef enum
+{
+    T9_MODE_LOWER,
+    T9_MODE_UPPER,
+    T9_MODE_NUMBERS,
+    T9_MODE_PREDICTIVE  // Dictionary based, one press per letter (needs lv_keyboard_t9_set_dictionary)
+} t9_mode_t;
+
+// Shift key (T9_CORE_KEY_SHIFT)
+typedef enum
+{
+    T9_SHIFT_OFF,
+    T9_SHIFT_ONCE, // Upper case for the next char
+    T9_SHIFT_USED, // The char is typed and may still cycle, lower case again from the next one
+} t9_shift_t;
+
+// Keys of the core, in the order of lv_keyboard_t9_key_t
+typedef enum
+{
+    T9_CORE_KEY_1,
+    T9_CORE_KEY_2,
+    T9_CORE_KEY_3,
+    T9_CORE_KEY_4,
+    T9_CORE_KEY_5,
+    T9_CORE_KEY_6,
+    T9_CORE_KEY_7,
+    T9_CORE_KEY_8,
+    T9_CORE_KEY_9,
+    T9_CORE_KEY_0,
+    T9_CORE_KEY_BACKSPACE,
+    T9_CORE_KEY_OK,    // No edit, ends the char like any other helper key
+    T9_CORE_KEY_CLOSE, // No edit
+    T9_CORE_KEY_SPACE,
+    T9_CORE_KEY_CASE,
+    T9_CORE_KEY_MODE,
+    T9_CORE_KEY_SHIFT,
+    T9_CORE_KEY_COUNT
+} t9_core_key_t;
+
+typedef enum
+{
+    T9_EDIT_INSERT,       // Insert text at the cursor
+    T9_EDIT_REPLACE_LAST, // Replace the char before the cursor (the open char) with text
+    T9_EDIT_DELETE,       // Delete cnt chars before the cursor
+} t9_edit_type_t;
+
+// Edit of the text before the cursor
+typedef struct
+{
+    uint8_t type;     // t9_edit_type_t
+    bool open;        // The inserted char may still be replaced by the next press (multi-tap)
+    uint16_t cnt;     // Chars to delete (T9_EDIT_DELETE)
+    const char *text; // NUL terminated UTF-8 text, in the charset pack or static (insert, replace)
+} t9_edit_t;
+
+/**
+ * Charset pack: the characters of the 10 T9 keys ('1'..'9', '0') for lower and upper case,
+ * usually generated by tools/t9_charset_gen.py and kept in flash.
+ * Keys are indexed by case * 10 + key, key 0 is '1' and key 9 is '0'.
+ */
+typedef struct
+{
+    const char *blob;                          // NUL terminated UTF-8 chars, back to back
+    const uint16_t *offs;                      // Byte offset in blob of every char, in key order
+    uint16_t key_first[2 * 10 + 1];            // First offs index of every key, the last entry is the total
+    const char *labels[2][10];                 // Key labels
+    const char *const *popover_maps[2][10];    // Long-press buttonmatrix maps, entries point into blob (NULL: paged)
+} t9_charset_t;
+
+// Built-in charset packs (src/lv_keyboard_t9_charset.c)
+extern const t9_charset_t lv_keyboard_t9_charset_default; // ASCII letters
+extern const t9_charset_t lv_keyboard_t9_charset_latin;   // ASCII and Portuguese/Spanish accents
+
+/**
+ * Multi-tap state of one input. Only the last pressed key can cycle, so it is the only one tracked.
+ * The owner may read the fields and set predictive, the functions change the rest.
+ */
+typedef struct
+{
+    const t9_charset_t *charset;
+    uint32_t last_press_time;
+    uint32_t timeout_ms; // Multi-tap timeout while the adaptive one is off
+    int8_t last_key;     // t9_core_key_t of the open char, -1 if none
+    uint8_t cycle_idx;
+    uint8_t mode;        // t9_mode_t
+    uint8_t shift;       // t9_shift_t, one-shot upper case of the shift key
+    bool predictive;     // T9_CORE_KEY_MODE also goes through T9_MODE_PREDICTIVE
+
+    // Adaptive timeout, from the EWMA of the intervals between taps cycling the same key
+    uint32_t tap_avg_x8;       // Average interval in ms << T9_ADAPT_SHIFT
+    uint16_t adapt_min_ms;     // Bounds of the timeout, adapt_max_ms 0 uses timeout_ms
+    uint16_t adapt_max_ms;
+    uint16_t adapt_timeout_ms; // Timeout in use
+    uint16_t adapt_miss;       // Interval of a same-key tap that came after the timeout, 0 if the last tap was not
+} t9_core_t;
+
+/**
+ * @brief Initialize the multi-tap state, lower case with no open char.
+ * @param core State to initialize
+ * @param charset Charset pack of the letter modes, NULL for lv_keyboard_t9_charset_default (referenced)
+ * @param timeout_ms Multi-tap timeout in milliseconds
+ */
+void t9_core_init(t9_core_t *core, const t9_charset_t *charset, uint32_t timeout_ms);
+
+/**
+ * @brief Handle a key press and write the resulting edits of the text.
+ * In T9_MODE_PREDICTIVE the letter keys 2..9 belong to the caller's dictionary, the core cycles
+ * them like in lower case.
+ * @param core Multi-tap state
+ * @param key Pressed key (t9_core_key_t)
+ * @param now Press time in ms, wrapping is fine
+ * @param edits Buffer receiving the edits, in order
+ * @param max Size of edits, T9_CORE_EDITS_MAX never drops an edit
+ * @return Number of edits written
+ */
+uint32_t t9_core_press(t9_core_t *core, uint32_t key, uint32_t now, t9_edit_t *edits, uint32_t max);
+
+/**
+ * @brief Close the open char: the next press starts a new one even on the same key.
+ * @param core Multi-tap state
+ */
+void t9_core_end_cycle(t9_core_t *core);
+
+/**
+ * @brief Set the mode, which also clears the one-shot shift. The open char stays open.
+ * @param core Multi-tap state
+ * @param mode New mode
+ */
+void t9_core_set_mode(t9_core_t *core, t9_mode_t mode);
+
+/**
+ * @brief Set the charset pack of the letter modes, which closes the open char.
+ * @param core Multi-tap state
+ * @param charset Charset pack, NULL for lv_keyboard_t9_charset_default (referenced)
+ */
+void t9_core_set_charset(t9_core_t *core, const t9_charset_t *charset);
+
+/**
+ * @brief Set the multi-tap timeout used while the adaptive one is off.
+ * @param core Multi-tap state
+ * @param ms Timeout in milliseconds
+ */
+void t9_core_set_timeout(t9_core_t *core, uint32_t ms);
+
+/**
+ * @brief Learn the multi-tap timeout from the tap cadence, starting from timeout_ms clamped to the bounds.
+ * @param core Multi-tap state
+ * @param min_ms Shortest timeout (at least 1 ms)
+ * @param max_ms Longest timeout (up to 65535 ms), 0 goes back to timeout_ms
+ * @return false if the bounds are invalid (the state is unchanged)
+ */
+bool t9_core_set_adaptive_timeout(t9_core_t *core, uint32_t min_ms, uint32_t max_ms);
+
+/**
+ * @brief Get the multi-tap timeout in use.
+ * @param core Multi-tap state
+ * @return The adaptive timeout if enabled, else timeout_ms, in milliseconds
+ */
+uint32_t t9_core_get_timeout(const t9_core_t *core);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // T9_CORE_H
@@ -4,50 +4,131 @@
  *
  * This widget provides a T9-style keyboard for LVGL, supporting cycling through characters,
  * symbol popovers on long-press, and helper buttons for space, backspace, OK, close, and mode switching.
+ * The button grid comes from a layout (see lv_keyboard_t9_layout.c), the characters of the letter
+ * modes from a charset pack (see lv_keyboard_t9_charset.c).
+ * An optional predictive mode looks the typed digit sequence up in a dictionary trie (see lv_keyboard_t9_dict.c).
  * Usage: Call lv_keyboard_t9_init(parent, ta) to create and link the keyboard to a textarea.
  */
 #include "lvgl.h"
 #include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
 
-// Buttonmatrix definitions
-#define T9_KEYBOARD_COLS 4
-#define T9_KEYBOARD_ROWS 4
-#define T9_BUTTON_COUNT 10
-
-static const char *t9_btn_labels[] = {
-    "1", "2", "3", LV_SYMBOL_BACKSPACE,
-    "4", "5", "6", LV_SYMBOL_OK,
-    "7", "8", "9", LV_SYMBOL_CLOSE,
-    "abc", "0", "space", LV_SYMBOL_NEW_LINE,
-    "" // End marker for buttonmatrix
+// What each key does, indexed by lv_keyboard_t9_key_t. The layout gives the key of a button, so a press
+// is two table loads and a switch.
+typedef enum
+{
+    T9_ACTION_CHAR,      // T9 key, char_idx selects the chars
+    T9_ACTION_BACKSPACE,
+    T9_ACTION_OK,
+    T9_ACTION_CLOSE,
+    T9_ACTION_SPACE,
+    T9_ACTION_CASE,      // abc / ABC toggle
+    T9_ACTION_MODE,      // T9 / T9+ / 123 toggle
+    T9_ACTION_SHIFT      // One-shot upper case
+} t9_action_t;
+
+typedef struct
+{
+    uint8_t action; // t9_action_t
+    int8_t char_idx; // T9 key index (0-9), -1 for helper keys
+    uint8_t underline; // Drawn with the helper key decoration (see t9_style_helper)
+} t9_btn_action_t;
+
+#define T9_BTN_CHAR(idx) {T9_ACTION_CHAR, (idx), 0}
+#define T9_BTN_HELPER(action) {(action), -1, 0}
+#define T9_BTN_HELPER_U(action) {(action), -1, 1}
+
+static const t9_btn_action_t t9_key_actions[LV_KEYBOARD_T9_KEY_COUNT] = {
+    T9_BTN_CHAR(0), T9_BTN_CHAR(1), T9_BTN_CHAR(2), T9_BTN_CHAR(3), T9_BTN_CHAR(4),
+    T9_BTN_CHAR(5), T9_BTN_CHAR(6), T9_BTN_CHAR(7), T9_BTN_CHAR(8), T9_BTN_CHAR(9),
+    T9_BTN_HELPER(T9_ACTION_BACKSPACE), T9_BTN_HELPER(T9_ACTION_OK), T9_BTN_HELPER(T9_ACTION_CLOSE),
+    T9_BTN_HELPER_U(T9_ACTION_SPACE), T9_BTN_HELPER_U(T9_ACTION_CASE), T9_BTN_HELPER_U(T9_ACTION_MODE),
+    T9_BTN_HELPER_U(T9_ACTION_SHIFT),
 };
 
-static const char t9_btn_symbols_0[] = {'0', '!', '"', '#', '$', '%', '&', '\'', '(', ')', '*', '+', ',', '-', '.', '/', 0};
-static const char t9_btn_symbols_1[] = {'1', ':', ';', '<', '=', '>', '?', '@', '[', '\\', ']', '^', '_', '`', '{', '|', '}', '~', 0};
+/*
+ * Underlined helper keys are marked with LV_BUTTONMATRIX_CTRL_CHECKED (they are not checkable, so
+ * taps never toggle it) and this style is added for the checked items. It undoes the theme's checked
+ * look with the default item colors, so the keys are only underlined and no draw task event is needed.
+ */
+static lv_style_t t9_style_helper;
+static bool t9_style_helper_inited = false;
+
+// Built-in theme, the static styles are initialized by lv_keyboard_t9_get_default_theme
+static lv_style_t t9_style_matrix;
+static lv_style_t t9_style_popover;
+static lv_style_t t9_style_bar;
+static lv_style_t t9_style_preedit;
+static const lv_keyboard_t9_theme_t t9_theme_default = {
+    &t9_style_matrix, &t9_style_popover, &t9_style_bar, &t9_style_preedit};
+static bool t9_theme_default_inited = false;
 
-static const char *const t9_btn_chars_lower[T9_BUTTON_COUNT] = {
-    NULL, "abc2", "def3", "ghi4", "jkl5", "mno6", "pqrs7", "tuv8", "wxyz9", NULL};
-static const char *const t9_btn_chars_upper[T9_BUTTON_COUNT] = {
-    NULL, "ABC2", "DEF3", "GHI4", "JKL5", "MNO6", "PQRS7", "TUV8", "WXYZ9", NULL};
-static const char *const t9_btn_chars_numbers[T9_BUTTON_COUNT] = {
-    "1", "2", "3", "4", "5", "6", "7", "8", "9", "0"};
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+// First letter of the digits 2..9, shown by the predictive mode past the end of the dictionary
+static const char t9_pred_fallback[] = "adgjmptw";
+#endif
 
-static t9_mode_t t9_mode = T9_MODE_LOWER;
-static int32_t t9_btn_last_pressed = -1;
-static uint8_t t9_btn_cycle_idx[T9_BUTTON_COUNT] = {0};
-static uint32_t t9_btn_last_press_time[T9_BUTTON_COUNT] = {0};
 static uint32_t t9_cycle_timeout_ms = 1000;
 
-static lv_obj_t *t9_btnmatrix = NULL;
-static lv_obj_t *t9_popover = NULL;
-static lv_obj_t *linked_ta = NULL;
-
 // --- Static function prototypes ---
-static int get_btn_char_idx(int row, int col);
-static void t9_update_btnmatrix_labels(void);
+static const t9_btn_action_t *t9_get_btn_action(const t9_keyboard_t *kb, uint32_t btn_id);
+static void t9_update_btnmatrix_labels(t9_keyboard_t *kb);
+static void t9_layout_apply(t9_keyboard_t *kb);
+static void t9_popover_close(t9_keyboard_t *kb);
+static const char *const *t9_popover_key_map(t9_keyboard_t *kb, bool upper, uint32_t char_idx, uint16_t *btn_cnt,
+                                             bool *paged);
+static lv_obj_t *t9_popover_prepare(t9_keyboard_t *kb, uint32_t slot, const char *const *map, uint16_t btn_cnt,
+                                    bool paged);
 static void t9_btnmatrix_event_cb(lv_event_t *e);
 static void t9_btnmatrix_longpress_cb(lv_event_t *e);
-static void t9_btnmatrix_drawtask_cb(lv_event_t *e);
+static void t9_btnmatrix_release_cb(lv_event_t *e);
+static void t9_apply_mode(t9_keyboard_t *kb, t9_mode_t mode);
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+static void t9_pred_reset(t9_keyboard_t *kb);
+static void t9_pred_event_cb(lv_event_t *e);
+static void t9_learn_confirmed(t9_keyboard_t *kb);
+#else
+#define t9_pred_reset(kb) do { } while (0)
+#endif
+static void t9_btnmatrix_delete_cb(lv_event_t *e);
+#if LV_KEYBOARD_T9_USE_KEYPAD
+static void t9_keypad_delete(t9_keyboard_t *kb);
+#endif
+static void t9_compose_commit(t9_keyboard_t *kb);
+static void t9_compose_discard(t9_keyboard_t *kb);
+static void t9_compose_timer_cb(lv_timer_t *timer);
+static void t9_dirty_begin(t9_keyboard_t *kb);
+static void t9_ta_add_text(t9_keyboard_t *kb, const char *txt);
+static bool t9_ta_add_joined(t9_keyboard_t *kb, const char *pre, const char *utf8, size_t len);
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+static void t9_display_invalidate_cb(lv_event_t *e);
+#endif
+#if LV_KEYBOARD_T9_USE_STATS
+static void t9_stats_handler_done(t9_keyboard_t *kb, uint32_t us);
+#endif
+
+// Keyboard state is the user data of the keyboard buttonmatrix
+static t9_keyboard_t *t9_get_keyboard(lv_obj_t *keyboard)
+{
+    return keyboard ? (t9_keyboard_t *)lv_obj_get_user_data(keyboard) : NULL;
+}
+
+// Add a theme style to an object, NULL keeps the LVGL theme only
+static void t9_theme_add(lv_obj_t *obj, const lv_style_t *style)
+{
+    if (obj && style)
+        lv_obj_add_style(obj, style, LV_PART_MAIN);
+}
+
+// Replace a theme style on an object (lv_obj_remove_style with NULL would remove every style)
+static void t9_theme_swap(lv_obj_t *obj, const lv_style_t *old_style, const lv_style_t *new_style)
+{
+    if (obj == NULL || old_style == new_style)
+        return;
+    if (old_style)
+        lv_obj_remove_style(obj, old_style, LV_PART_MAIN);
+    t9_theme_add(obj, new_style);
+}
 
 /**
  * Initialize and create a T9 keyboard linked to a given textarea.
@@ -64,29 +145,126 @@ lv_obj_t *lv_keyboard_t9_init(lv_obj_t *parent, lv_obj_t *ta)
         return NULL;
     }
 
-    linked_ta = ta;
-    lv_obj_update_layout(parent); // Just to make sure the object size is already calculated...
+    t9_keyboard_t *kb = lv_malloc_zeroed(sizeof(t9_keyboard_t));
+    if (kb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_init: out of memory");
+        return NULL;
+    }
+    kb->ta = ta;
+    t9_core_init(&kb->core, &lv_keyboard_t9_charset_default, t9_cycle_timeout_ms); // Same labels as the ROM maps
+    kb->bs_word_ms = T9_BACKSPACE_WORD_MS;
+    kb->bs_clear_ms = T9_BACKSPACE_CLEAR_MS;
+#if LV_KEYBOARD_T9_USE_KEYPAD
+    kb->key_down = -1;
+    kb->keypad_event = -1;
+#endif
+    kb->layout = &lv_keyboard_t9_layout_4x4;
+    kb->theme = lv_keyboard_t9_get_default_theme();
 
     // Create buttonmatrix and add to keyboard
-    t9_btnmatrix = lv_buttonmatrix_create(parent);
-    lv_obj_set_size(t9_btnmatrix, lv_obj_get_width(parent), lv_obj_get_height(parent));
-    lv_obj_center(t9_btnmatrix);
-    //  Make main keyboard buttons bigger
-    lv_obj_set_style_pad_all(t9_btnmatrix, 0, 0);
-    lv_obj_set_style_pad_row(t9_btnmatrix, 4, 0);
-    lv_obj_set_style_pad_column(t9_btnmatrix, 4, 0);
-    t9_update_btnmatrix_labels();
-    lv_obj_add_event_cb(t9_btnmatrix, t9_btnmatrix_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
-    lv_obj_add_event_cb(t9_btnmatrix, t9_btnmatrix_longpress_cb, LV_EVENT_LONG_PRESSED, NULL);
-    lv_obj_add_event_cb(t9_btnmatrix, t9_btnmatrix_drawtask_cb, LV_EVENT_DRAW_TASK_ADDED, NULL);
-    lv_obj_add_flag(t9_btnmatrix, LV_OBJ_FLAG_SEND_DRAW_TASK_EVENTS);
+    kb->btnmatrix = lv_buttonmatrix_create(parent);
+    lv_obj_set_user_data(kb->btnmatrix, kb);
+    // Relative sizes: nothing to compute now, the matrix follows the parent when it is resized
+    lv_obj_set_size(kb->btnmatrix, lv_pct(100), lv_pct(100));
+    lv_obj_center(kb->btnmatrix);
+    // Like lv_keyboard: a tap on a key must not take the focus from the textarea
+    lv_obj_remove_flag(kb->btnmatrix, LV_OBJ_FLAG_CLICK_FOCUSABLE);
+    t9_theme_add(kb->btnmatrix, kb->theme->matrix);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_btnmatrix_event_cb, LV_EVENT_VALUE_CHANGED, kb);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_btnmatrix_longpress_cb, LV_EVENT_LONG_PRESSED, kb);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_btnmatrix_release_cb, LV_EVENT_RELEASED, kb);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_btnmatrix_release_cb, LV_EVENT_PRESS_LOST, kb);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_btnmatrix_delete_cb, LV_EVENT_DELETE, kb);
+
+    // Helper key decoration
+    if (!t9_style_helper_inited)
+    {
+        lv_style_init(&t9_style_helper);
+        lv_style_set_text_decor(&t9_style_helper, LV_TEXT_DECOR_UNDERLINE);
+        lv_style_set_bg_color(&t9_style_helper, lv_obj_get_style_bg_color(kb->btnmatrix, LV_PART_ITEMS));
+        lv_style_set_bg_opa(&t9_style_helper, lv_obj_get_style_bg_opa(kb->btnmatrix, LV_PART_ITEMS));
+        lv_style_set_text_color(&t9_style_helper, lv_obj_get_style_text_color(kb->btnmatrix, LV_PART_ITEMS));
+        t9_style_helper_inited = true;
+    }
+    lv_obj_add_style(kb->btnmatrix, &t9_style_helper, LV_PART_ITEMS | LV_STATE_CHECKED);
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+    t9_key_cache_attach(kb); // Images rendered once the matrix is laid out
+#endif
+    t9_layout_apply(kb);
 
-    //Disable Repeat for all buttons
-    lv_buttonmatrix_set_button_ctrl_all(t9_btnmatrix, LV_BUTTONMATRIX_CTRL_WIDTH_1 | LV_BUTTONMATRIX_CTRL_NO_REPEAT);
-    // Enable repeat for Backspace button, the others will be disabled....
-    lv_buttonmatrix_clear_button_ctrl(t9_btnmatrix, 3, LV_BUTTONMATRIX_CTRL_NO_REPEAT); // Last button is newline
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    // Candidate bar for the predictive mode, shown on top of the matrix only in that mode
+    kb->pred_bar = lv_buttonmatrix_create(parent);
+    lv_obj_set_size(kb->pred_bar, lv_pct(100), lv_pct(T9_PRED_BAR_PCT));
+    lv_obj_align(kb->pred_bar, LV_ALIGN_TOP_MID, 0, 0);
+    t9_theme_add(kb->pred_bar, kb->theme->bar);
+    lv_obj_remove_flag(kb->pred_bar, LV_OBJ_FLAG_CLICK_FOCUSABLE);
+    lv_obj_add_flag(kb->pred_bar, LV_OBJ_FLAG_HIDDEN);
+    // Always T9_PRED_CANDIDATES buttons, so the LVGL button arrays are allocated here once
+    for (uint32_t i = 0; i < T9_PRED_CANDIDATES; i++)
+        kb->pred_candidates[i] = "";
+    kb->pred_candidates[T9_PRED_CANDIDATES] = NULL;
+    lv_buttonmatrix_set_map(kb->pred_bar, kb->pred_candidates);
+    lv_buttonmatrix_set_button_ctrl_all(kb->pred_bar, LV_BUTTONMATRIX_CTRL_NO_REPEAT);
+    kb->pred_bar_cnt = T9_PRED_CANDIDATES;
+    lv_obj_add_event_cb(kb->pred_bar, t9_pred_event_cb, LV_EVENT_VALUE_CHANGED, kb);
+#endif
 
-    return t9_btnmatrix;
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+    lv_display_add_event_cb(lv_obj_get_display(kb->btnmatrix), t9_display_invalidate_cb, LV_EVENT_INVALIDATE_AREA, kb);
+#endif
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+    t9_rank_attach(kb); // Ranks synchronously if the worker can not run
+#endif
+#if LV_KEYBOARD_T9_USE_CMD_QUEUE
+    t9_cmd_attach(kb);
+#endif
+
+    return kb->btnmatrix;
+}
+
+/**
+ * Free the keyboard state when its buttonmatrix is deleted, together with the sibling
+ * objects it owns (they are children of the same parent, created after the matrix).
+ */
+static void t9_btnmatrix_delete_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+    lv_display_remove_event_cb_with_user_data(lv_obj_get_display(kb->btnmatrix), t9_display_invalidate_cb, kb);
+#endif
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+    t9_rank_detach(kb);
+#endif
+#if LV_KEYBOARD_T9_USE_CMD_QUEUE
+    t9_cmd_detach(kb);
+#endif
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+    t9_key_cache_detach(kb);
+#endif
+    if (kb->commit_timer)
+        lv_timer_delete(kb->commit_timer);
+#if LV_KEYBOARD_T9_USE_KEYPAD
+    if (kb->keypad_timer)
+        lv_timer_delete(kb->keypad_timer);
+    if (kb->keypad)
+        t9_keypad_delete(kb);
+#endif
+    for (int i = 0; i < T9_POPOVER_CACHE_SIZE; i++)
+    {
+        if (kb->popovers[i])
+            lv_obj_delete(kb->popovers[i]);
+    }
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    if (kb->pred_bar)
+        lv_obj_delete(kb->pred_bar);
+#endif
+    if (kb->preedit)
+        lv_obj_delete(kb->preedit);
+    t9_text_detach(kb); // The textarea gets a copy of the reserved text
+    lv_free(kb->text_buf);
+    lv_free(kb);
 }
 
 /**
@@ -97,7 +275,8 @@ lv_obj_t *lv_keyboard_t9_init(lv_obj_t *parent, lv_obj_t *ta)
  */
 void lv_keyboard_t9_set_textarea(lv_obj_t *keyboard, lv_obj_t *ta)
 {
-    if (keyboard == NULL)
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
         LV_LOG_WARN("lv_keyboard_t9_set_textarea: keyboard is NULL");
         return;
@@ -107,13 +286,75 @@ void lv_keyboard_t9_set_textarea(lv_obj_t *keyboard, lv_obj_t *ta)
         LV_LOG_WARN("lv_keyboard_t9_set_textarea: ta is NULL");
         return;
     }
-    linked_ta = ta;
+    t9_set_textarea(kb, ta);
+}
+
+void t9_set_textarea(t9_keyboard_t *kb, lv_obj_t *ta)
+{
+    t9_compose_commit(kb); // Pending and composed text belong to the previous textarea
+    t9_pred_reset(kb);
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    kb->learn_mark = 0; // Nothing of the new text was learned yet
+#endif
+    t9_core_end_cycle(&kb->core);
+    t9_text_detach(kb);
+    kb->ta = ta;
+    t9_text_attach(kb); // Nothing to watch when unlinked
 }
 
+/**
+ * Get the currently linked textarea of the T9 keyboard.
+ *
+ * @param keyboard Pointer to the T9 keyboard object.
+ * @return Pointer to the linked textarea object, or NULL if none is linked.
+ */
 lv_obj_t *lv_keyboard_t9_get_textarea(lv_obj_t *keyboard)
 {
-    LV_UNUSED(keyboard); // For now, only one global linked_ta
-    return linked_ta;
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    return kb ? kb->ta : NULL;
+}
+
+/**
+ * @brief Insert a text at the cursor of the linked textarea, e.g. a template or a macro.
+ * The pending char is written together with the text and the predictive word is committed,
+ * so the textarea is edited (laid out and redrawn) once whatever the length: in place with a
+ * reserved text buffer (lv_keyboard_t9_reserve_text), else joined for lv_textarea_add_text (with
+ * lv_malloc from T9_INSERT_STACK_SIZE bytes). The next tap starts a new cycle instead of replacing
+ * the last inserted char.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param utf8 Text to insert, does not need to be NUL terminated
+ * @param len Bytes of utf8 to insert
+ */
+void lv_keyboard_t9_insert_text(lv_obj_t *keyboard, const char *utf8, size_t len)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL || utf8 == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_insert_text: keyboard or utf8 is NULL");
+        return;
+    }
+    if (kb->ta == NULL)
+        return; // Unlinked, e.g. the shared keyboard once its last textarea is deleted
+    for (size_t i = 0; i < len; i++)
+    {
+        if (utf8[i] == '\0')
+        {
+            len = i; // The textarea text ends there
+            break;
+        }
+    }
+    if (kb->pending[0] == '\0' && len == 0)
+        return;
+
+    // The pending char and the text in one edit
+    t9_dirty_begin(kb);
+    if (!t9_ta_add_joined(kb, kb->pending, utf8, len))
+        return;
+    if (kb->pending[0] != '\0')
+        T9_STAT_INC(kb, commits);
+    t9_compose_discard(kb);
+    t9_pred_reset(kb);
+    t9_core_end_cycle(&kb->core);
 }
 
 /**
@@ -123,9 +364,27 @@ lv_obj_t *lv_keyboard_t9_get_textarea(lv_obj_t *keyboard)
  */
 void lv_keyboard_t9_set_mode(lv_obj_t *keyboard, t9_mode_t mode)
 {
-    LV_UNUSED(keyboard); // For now, only one global mode
-    t9_mode = mode;
-    t9_update_btnmatrix_labels();
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_set_mode: keyboard is NULL");
+        return;
+    }
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    if (mode == T9_MODE_PREDICTIVE && kb->dict == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_set_mode: no dictionary set, predictive mode unavailable");
+        return;
+    }
+#else
+    if (mode == T9_MODE_PREDICTIVE)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_set_mode: built without LV_KEYBOARD_T9_USE_PREDICTIVE");
+        return;
+    }
+#endif
+    t9_dirty_begin(kb); // A rejected mode keeps the report of the previous operation
+    t9_apply_mode(kb, mode);
 }
 
 /**
@@ -135,8 +394,8 @@ void lv_keyboard_t9_set_mode(lv_obj_t *keyboard, t9_mode_t mode)
  */
 t9_mode_t lv_keyboard_t9_get_mode(lv_obj_t *keyboard)
 {
-    LV_UNUSED(keyboard); // For now, only one global mode
-    return t9_mode;
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    return kb ? (t9_mode_t)kb->core.mode : T9_MODE_LOWER;
 }
 
 /**
@@ -157,391 +416,1929 @@ uint32_t lv_keyboard_t9_get_cycle_timeout(void)
     return t9_cycle_timeout_ms;
 }
 
-// Helper to set callback as user data on parent keyboard object
-void lv_keyboard_t9_set_event_cb(lv_obj_t *keyboard, lv_keyboard_t9_event_cb_t cb)
+// Multi-tap timeout of a keyboard: the global one, or the one learned from its tap cadence
+static uint32_t t9_cycle_timeout(t9_keyboard_t *kb)
 {
-    lv_obj_set_user_data(keyboard, (void *)cb);
+    t9_core_set_timeout(&kb->core, t9_cycle_timeout_ms); // The global timeout may have changed
+    return t9_core_get_timeout(&kb->core);
 }
 
-static void t9_btnmatrix_drawtask_cb(lv_event_t *e)
+/**
+ * @brief Learn the multi-tap timeout of a keyboard from the user's tap cadence.
+ * The intervals between taps cycling the same key are averaged (EWMA) and the timeout is kept
+ * at T9_ADAPT_MARGIN_PCT of the average. A backspace right after a same-key tap that came too
+ * late to cycle counts that interval too, so the timeout also grows for slow users.
+ * It starts from the global timeout, clamped to the bounds.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param min_ms Shortest timeout (at least 1 ms)
+ * @param max_ms Longest timeout (up to 65535 ms), 0 goes back to the global timeout
+ */
+void lv_keyboard_t9_set_adaptive_timeout(lv_obj_t *keyboard, uint32_t min_ms, uint32_t max_ms)
 {
-    lv_obj_t *obj = lv_event_get_target_obj(e);
-    lv_draw_task_t *draw_task = lv_event_get_draw_task(e);
-    lv_draw_dsc_base_t *base_dsc = (lv_draw_dsc_base_t *)lv_draw_task_get_draw_dsc(draw_task);
-
-    if (base_dsc->part == LV_PART_ITEMS)
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        if (base_dsc->id1 == 12 || base_dsc->id1 == 14 || base_dsc->id1 == 15)
-        {
-            lv_draw_label_dsc_t *label_draw_dsc = lv_draw_task_get_label_dsc(draw_task);
-            if (label_draw_dsc)
-            {
-                label_draw_dsc->decor |= LV_TEXT_DECOR_UNDERLINE;
-            }
-        }
+        LV_LOG_WARN("lv_keyboard_t9_set_adaptive_timeout: keyboard is NULL");
+        return;
     }
+    t9_core_set_timeout(&kb->core, t9_cycle_timeout_ms); // Start from the global timeout
+    if (!t9_core_set_adaptive_timeout(&kb->core, min_ms, max_ms))
+        LV_LOG_WARN("lv_keyboard_t9_set_adaptive_timeout: invalid bounds");
 }
 
-// Helper to get callback from parent keyboard object
-static lv_keyboard_t9_event_cb_t t9_get_event_cb(lv_obj_t *keyboard)
+/**
+ * @brief Get the multi-tap timeout used by a keyboard.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @return The adaptive timeout if enabled, else the global one, in milliseconds
+ */
+uint32_t lv_keyboard_t9_get_effective_timeout(lv_obj_t *keyboard)
 {
-    return (lv_keyboard_t9_event_cb_t)lv_obj_get_user_data(keyboard);
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    return kb ? t9_cycle_timeout(kb) : t9_cycle_timeout_ms;
 }
 
 /**
- * Get the T9 button index (0-9) for a given grid row/col.
- * Returns -1 for helper buttons (non-T9).
+ * @brief Set how a held backspace accelerates. It deletes one char per repeat at first, one word
+ * per repeat (with the spaces before it) once held for word_ms, and clears the textarea once held
+ * for clear_ms. Every repeat is a single textarea update.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param word_ms Hold time before deleting words (up to 65535 ms), 0 to delete chars only
+ * @param clear_ms Hold time before clearing the textarea (up to 65535 ms), 0 to never clear it
  */
-static int get_btn_char_idx(int row, int col)
+void lv_keyboard_t9_set_backspace_accel(lv_obj_t *keyboard, uint32_t word_ms, uint32_t clear_ms)
 {
-    if (row == 0 && col < 3)
-    {
-        return col; // 1,2,3
-    }
-    if (row == 1 && col < 3)
-    {
-        return col + 3; // 4,5,6
-    }
-    if (row == 2 && col < 3)
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        return col + 6; // 7,8,9
+        LV_LOG_WARN("lv_keyboard_t9_set_backspace_accel: keyboard is NULL");
+        return;
     }
-    if (row == 3 && col == 1)
+    kb->bs_word_ms = (uint16_t)LV_MIN(word_ms, UINT16_MAX);
+    kb->bs_clear_ms = (uint16_t)LV_MIN(clear_ms, UINT16_MAX);
+}
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+/**
+ * @brief Set the dictionary used by the predictive mode.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param dict Dictionary created with lv_keyboard_t9_dict_create, or NULL to disable the predictive mode
+ */
+void lv_keyboard_t9_set_dictionary(lv_obj_t *keyboard, const t9_dict_t *dict)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        return 9; // 0
+        LV_LOG_WARN("lv_keyboard_t9_set_dictionary: keyboard is NULL");
+        return;
     }
-    // Defensive: log warning if invalid grid position
-    if (row < 0 || row >= T9_KEYBOARD_ROWS || col < 0 || col >= T9_KEYBOARD_COLS)
+    t9_pred_reset(kb);
+    kb->dict = dict;
+    kb->core.predictive = dict != NULL; // The mode key goes through the predictive mode
+    if (dict == NULL && kb->core.mode == T9_MODE_PREDICTIVE)
+        t9_apply_mode(kb, T9_MODE_LOWER);
+}
+
+#endif
+
+/**
+ * Set the charset pack of the letter modes.
+ *
+ * Only the key labels that differ between the packs are swapped and redrawn. The pack is
+ * referenced, so it must stay valid while the keyboard uses it (usually a const in flash).
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param charset Charset pack, NULL for lv_keyboard_t9_charset_default
+ */
+void lv_keyboard_t9_set_charset(lv_obj_t *keyboard, const lv_keyboard_t9_charset_t *charset)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        LV_LOG_WARN("get_btn_char_idx: invalid row/col (%d,%d)", row, col);
+        LV_LOG_WARN("lv_keyboard_t9_set_charset: keyboard is NULL");
+        return;
     }
-    return -1; // helper buttons or invalid
+    t9_dirty_begin(kb);
+    t9_compose_commit(kb);
+    t9_popover_close(kb);
+    t9_core_set_charset(&kb->core, charset);
+    t9_update_btnmatrix_labels(kb);
+    t9_key_cache_invalidate(kb);
 }
 
 /**
- * Get the currently linked textarea of the T9 keyboard.
- *
- * @param keyboard Pointer to the T9 keyboard object.
- * @return Pointer to the linked textarea object, or NULL if none is linked.
+ * @brief Change the button layout of the keyboard, e.g. lv_keyboard_t9_layout_phone on narrow screens.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param layout Layout to use, NULL for lv_keyboard_t9_layout_4x4 (referenced, not copied)
  */
-// Update buttonmatrix labels by setting a new map
-static void t9_update_btnmatrix_labels(void)
+void lv_keyboard_t9_set_layout(lv_obj_t *keyboard, const t9_layout_t *layout)
 {
-    // Rebuild the buttonmatrix map based on current mode
-    // 4 rows * 4 cols + 4 newlines + 1 NULL = 21
-    static const char *map[(T9_KEYBOARD_ROWS * T9_KEYBOARD_COLS) + T9_KEYBOARD_ROWS + 1];
-    static char buf[T9_KEYBOARD_ROWS * T9_KEYBOARD_COLS][8];
-    int idx = 0;
-    for (int row = 0; row < T9_KEYBOARD_ROWS; row++)
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        for (int col = 0; col < T9_KEYBOARD_COLS; col++)
-        {
-            int char_idx = get_btn_char_idx(row, col);
-            int buf_idx = row * T9_KEYBOARD_COLS + col;
-            if (char_idx >= 0)
-            {
-                if (t9_mode == T9_MODE_NUMBERS)
-                {
-                    map[idx++] = t9_btn_chars_numbers[char_idx];
-                }
-                else if (char_idx == 0)
-                {
-                    lv_snprintf(buf[buf_idx], sizeof(buf[buf_idx]), "%c%c%c...", t9_btn_symbols_1[0], t9_btn_symbols_1[1], t9_btn_symbols_1[2]);
-                    map[idx++] = buf[buf_idx];
-                }
-                else if (char_idx == 9)
-                {
-                    lv_snprintf(buf[buf_idx], sizeof(buf[buf_idx]), "%c%c%c...", t9_btn_symbols_0[0], t9_btn_symbols_0[1], t9_btn_symbols_0[2]);
-                    map[idx++] = buf[buf_idx];
-                }
-                else
-                {
-                    map[idx++] = (t9_mode == T9_MODE_UPPER) ? t9_btn_chars_upper[char_idx] : t9_btn_chars_lower[char_idx];
-                }
-            }
-            else
-            {
-                // Helper buttons
-                if (row == 3 && col == 0)
-                {
-                    map[idx++] = (t9_mode == T9_MODE_LOWER) ? "abc" : (t9_mode == T9_MODE_UPPER) ? "ABC"
-                                                                                                 : "abc";
-                }
-                else if (row == 3 && col == 2)
-                {
-                    map[idx++] = "space";
-                }
-                else if (row == 3 && col == 3)
-                {
-                    map[idx++] = (t9_mode == T9_MODE_NUMBERS) ? "123" : "T9";
-                }
-                else
-                {
-                    map[idx++] = t9_btn_labels[row * T9_KEYBOARD_COLS + col];
-                }
-            }
-        }
-        map[idx++] = "\n"; // Add newline after each row
+        LV_LOG_WARN("lv_keyboard_t9_set_layout: keyboard is NULL");
+        return;
     }
-    // Remove the last newline
-    map[idx - 1] = NULL; // End marker
-    map[idx] = NULL;     // End marker
-    lv_buttonmatrix_set_map(t9_btnmatrix, map);
+    if (layout == NULL)
+        layout = &lv_keyboard_t9_layout_4x4;
+    if (kb->layout == layout)
+        return;
+    t9_dirty_begin(kb);
+    t9_compose_commit(kb);
+    t9_core_end_cycle(&kb->core); // The next char starts on the new layout
+    t9_popover_close(kb);
+    kb->layout = layout;
+    t9_layout_apply(kb);
 }
 
 /**
- * Event callback for buttonmatrix value changes (button presses).
- * Handles character cycling, helper buttons, and mode switching.
+ * Get the built-in theme of the keyboard objects. Its styles are static, initialized on the
+ * first call and shared by all keyboards, instead of a local style allocated per object.
  *
- * @param e Pointer to the LVGL event
+ * @return The built-in theme
  */
-static void t9_btnmatrix_event_cb(lv_event_t *e)
+const lv_keyboard_t9_theme_t *lv_keyboard_t9_get_default_theme(void)
 {
-    lv_obj_t *btnmatrix = lv_event_get_target(e);
-    uint16_t btn_id = lv_buttonmatrix_get_selected_button(btnmatrix);
-    const char *txt = lv_buttonmatrix_get_button_text(btnmatrix, btn_id);
-    // Get event Type
-    lv_event_code_t event_code = lv_event_get_code(e);
+    if (!t9_theme_default_inited)
+    {
+        // Bigger keys: no outer padding, small gaps
+        lv_style_init(&t9_style_matrix);
+        lv_style_set_pad_all(&t9_style_matrix, 0);
+        lv_style_set_pad_row(&t9_style_matrix, 4);
+        lv_style_set_pad_column(&t9_style_matrix, 4);
 
-    // Print btn_id
-    //LV_LOG_USER("t9_btnmatrix_event_cb: btn_id=%d", btn_id);
+        lv_style_init(&t9_style_popover);
+        lv_style_set_border_color(&t9_style_popover, lv_color_hex(0x8888ff));
+        lv_style_set_border_width(&t9_style_popover, 2);
+        lv_style_set_pad_all(&t9_style_popover, 6);
+        lv_style_set_pad_row(&t9_style_popover, 8); // Comfortable row spacing
+        lv_style_set_pad_column(&t9_style_popover, 8);
 
-    if (!txt || !linked_ta)
-        return;
+        lv_style_init(&t9_style_bar);
+        lv_style_set_pad_all(&t9_style_bar, 0);
+        lv_style_set_pad_column(&t9_style_bar, 4);
 
-    if(t9_popover) {
-        // If popover is open, ignore all button presses
-        return;
+        lv_style_init(&t9_style_preedit);
+        lv_style_set_bg_opa(&t9_style_preedit, LV_OPA_COVER);
+        lv_style_set_border_width(&t9_style_preedit, 2);
+        lv_style_set_border_color(&t9_style_preedit, lv_color_hex(0x8888ff));
+        lv_style_set_pad_all(&t9_style_preedit, 4);
+        t9_theme_default_inited = true;
     }
+    return &t9_theme_default;
+}
 
-    // Helper buttons
-    if (lv_strcmp(txt, LV_SYMBOL_BACKSPACE) == 0)
+/**
+ * Style the keyboard objects with another theme. The styles of the previous theme are removed
+ * from the existing objects (the popovers included) and the new ones added, objects created
+ * later get the new theme too.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param theme Theme referenced by the keyboard, or NULL for lv_keyboard_t9_get_default_theme()
+ */
+void lv_keyboard_t9_set_theme(lv_obj_t *keyboard, const lv_keyboard_t9_theme_t *theme)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        lv_textarea_delete_char(linked_ta);
+        LV_LOG_WARN("lv_keyboard_t9_set_theme: keyboard is NULL");
         return;
     }
-    if (lv_strcmp(txt, "space") == 0)
+    if (theme == NULL)
+        theme = lv_keyboard_t9_get_default_theme();
+    const lv_keyboard_t9_theme_t *old = kb->theme;
+    kb->theme = theme;
+    t9_theme_swap(kb->btnmatrix, old->matrix, theme->matrix);
+    for (int i = 0; i < T9_POPOVER_CACHE_SIZE; i++)
+        t9_theme_swap(kb->popovers[i], old->popover, theme->popover);
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    t9_theme_swap(kb->pred_bar, old->bar, theme->bar);
+#endif
+    t9_theme_swap(kb->preedit, old->preedit, theme->preedit);
+    t9_key_cache_invalidate(kb);
+}
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+/**
+ * @brief Set the learned words of the predictive mode.
+ *
+ * Learned words matching the typed digits are ranked before the dictionary ones, and the words
+ * of the textarea are learned when OK is pressed (before LV_KEYBOARD_T9_EVENT_READY is sent):
+ * the words after the text learned by the previous OK, never those of a password textarea.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param learn Learned words created with lv_keyboard_t9_learn_create, or NULL to disable learning
+ */
+void lv_keyboard_t9_set_learn(lv_obj_t *keyboard, t9_learn_t *learn)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        lv_textarea_add_text(linked_ta, " ");
+        LV_LOG_WARN("lv_keyboard_t9_set_learn: keyboard is NULL");
         return;
     }
-    if (lv_strcmp(txt, LV_SYMBOL_OK) == 0)
+    t9_pred_reset(kb);
+    kb->learn = learn;
+}
+
+// FNV-1a of n bytes
+static uint32_t t9_learn_hash(const char *text, uint32_t n)
+{
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < n; i++)
+        h = (h ^ (uint8_t)text[i]) * 16777619u;
+    return h;
+}
+
+// OK pressed: learn the words confirmed since the last OK, the text before them was already learned
+static void t9_learn_confirmed(t9_keyboard_t *kb)
+{
+    if (kb->learn == NULL || lv_textarea_get_password_mode(kb->ta))
+        return; // No passwords nor PINs in the persistent log
+    const char *text = lv_textarea_get_text(kb->ta);
+    uint32_t len = (uint32_t)lv_strlen(text);
+    uint32_t from = kb->learn_mark;
+    if (from > len || t9_learn_hash(text, from) != kb->learn_mark_hash)
+        from = 0; // Replaced (e.g. cleared by the application), all of it is new
+    // A word continued after the last OK is learned whole
+    while (from > 0)
     {
-        lv_keyboard_t9_event_cb_t cb = t9_get_event_cb(btnmatrix);
-        if (cb)
-            cb(btnmatrix, LV_KEYBOARD_T9_EVENT_READY);
-        return;
+        char l = (char)(text[from - 1] | 0x20); // ASCII lower case
+        if (l < 'a' || l > 'z')
+            break;
+        from--;
     }
-    if (lv_strcmp(txt, LV_SYMBOL_CLOSE) == 0)
+    lv_keyboard_t9_learn_text(kb->learn, text + from);
+    kb->learn_mark = len;
+    kb->learn_mark_hash = t9_learn_hash(text, len);
+}
+
+#endif
+
+/**
+ * Enable or disable the composition buffer.
+ *
+ * When enabled, the character being cycled is shown in a small preedit label on the keyboard
+ * and only written to the textarea when committed: on cycle timeout, on another key, or on a
+ * helper key (space, OK, mode...). Long textareas are then touched once per char, not per tap.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param en true to enable, false to write every tap directly to the textarea (default)
+ */
+void lv_keyboard_t9_set_compose_mode(lv_obj_t *keyboard, bool en)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        lv_keyboard_t9_event_cb_t cb = t9_get_event_cb(btnmatrix);
-        if (cb)
-            cb(btnmatrix, LV_KEYBOARD_T9_EVENT_CANCEL);
+        LV_LOG_WARN("lv_keyboard_t9_set_compose_mode: keyboard is NULL");
         return;
     }
-    if (lv_strcmp(txt, "T9") == 0 || lv_strcmp(txt, "123") == 0)
+    t9_compose_commit(kb);
+    kb->compose = en;
+    if (en && kb->preedit == NULL)
     {
-        t9_mode = (t9_mode == T9_MODE_NUMBERS) ? T9_MODE_LOWER : T9_MODE_NUMBERS;
-        t9_update_btnmatrix_labels();
-        return;
+        kb->preedit = lv_label_create(lv_obj_get_parent(kb->btnmatrix));
+        t9_theme_add(kb->preedit, kb->theme->preedit);
+        lv_obj_align(kb->preedit, LV_ALIGN_TOP_MID, 0, 0);
+        lv_obj_add_flag(kb->preedit, LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_FLOATING);
     }
-    if (lv_strcmp(txt, "abc") == 0 || lv_strcmp(txt, "ABC") == 0)
+    if (en && kb->commit_timer == NULL)
     {
-        t9_mode = (t9_mode == T9_MODE_LOWER) ? T9_MODE_UPPER : T9_MODE_LOWER;
-        t9_update_btnmatrix_labels();
-        return;
+        // Created now and paused, a cycled char only restarts it
+        kb->commit_timer = lv_timer_create(t9_compose_timer_cb, t9_cycle_timeout(kb), kb);
+        lv_timer_pause(kb->commit_timer);
     }
+}
 
-    // If repeated event, ignore (to avoid multiple inputs on long-press)
-    if (event_code != LV_EVENT_VALUE_CHANGED)
-        return;
-
-    // T9 cycling logic
-    int char_idx = get_btn_char_idx(btn_id / T9_KEYBOARD_COLS, btn_id % T9_KEYBOARD_COLS);
-
-    //LV_LOG_USER("t9_btnmatrix_event_cb: char_idx=%d", char_idx);
-
-    if (char_idx < 0 || char_idx >= T9_BUTTON_COUNT)
-        return;
-
-    const char *chars = NULL;
-    if (t9_mode == T9_MODE_NUMBERS)
-    {
-        chars = t9_btn_chars_numbers[char_idx];
-    }
-    else if (t9_mode == T9_MODE_UPPER)
+/**
+ * Create ahead what the hot paths would create on first use, so that the presses, multi-tap cycles,
+ * mode toggles, popovers and candidate bar of the keyboard no longer allocate:
+ *  - a popover object for every button count of the charset pack (both cases, pages included),
+ *    mapped and sized. With more counts than T9_POPOVER_CACHE_SIZE the others are re-mapped on
+ *    long-press, which reallocates their buttons (a warning tells).
+ *  - the text of the linked textarea is copied into the reserved buffer (lv_keyboard_t9_reserve_text).
+ * The composition timer is created with the compose mode and the candidate bar with the keyboard.
+ * Call it again after lv_keyboard_t9_set_charset.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ */
+void lv_keyboard_t9_warm_up(lv_obj_t *keyboard)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        chars = t9_btn_chars_upper[char_idx];
-        if(char_idx == 0) chars = t9_btn_symbols_1; // 1 button
-        if(char_idx == 9) chars = t9_btn_symbols_0; // 0 button
+        LV_LOG_WARN("lv_keyboard_t9_warm_up: keyboard is NULL");
+        return;
     }
-    else
+    t9_popover_close(kb);
+    uint32_t warmed = 0; // Slots mapped by this call, bit per slot
+    bool full = false;
+    for (uint32_t i = 0; i < 2 * T9_BUTTON_COUNT; i++)
     {
-        chars = t9_btn_chars_lower[char_idx];
-        if(char_idx == 0) chars = t9_btn_symbols_1; // 1 button
-        if(char_idx == 9) chars = t9_btn_symbols_0; // 0 button
+        uint16_t btn_cnt;
+        bool paged;
+        const char *const *map = t9_popover_key_map(kb, i >= T9_BUTTON_COUNT, i % T9_BUTTON_COUNT, &btn_cnt, &paged);
+        if (map == NULL)
+            continue;
+        uint32_t slot = T9_POPOVER_CACHE_SIZE;
+        for (uint32_t s = 0; s < T9_POPOVER_CACHE_SIZE && slot == T9_POPOVER_CACHE_SIZE; s++)
+        {
+            if (kb->popovers[s] && kb->popover_btn_cnt[s] == btn_cnt)
+                slot = s;
+        }
+        if (slot < T9_POPOVER_CACHE_SIZE && (warmed & (1u << slot)))
+            continue; // This count is done
+        // Else a slot not mapped by this call, empty or left from another charset
+        for (uint32_t s = 0; s < T9_POPOVER_CACHE_SIZE && slot == T9_POPOVER_CACHE_SIZE; s++)
+        {
+            if (!(warmed & (1u << s)))
+                slot = s;
+        }
+        if (slot == T9_POPOVER_CACHE_SIZE)
+        {
+            if (!full)
+                LV_LOG_WARN("lv_keyboard_t9_warm_up: more popover sizes than T9_POPOVER_CACHE_SIZE");
+            full = true;
+            continue;
+        }
+        lv_obj_add_flag(t9_popover_prepare(kb, slot, map, btn_cnt, paged), LV_OBJ_FLAG_HIDDEN);
+        warmed |= 1u << slot;
     }
-    if (!chars)
+    kb->page_count = 0; // No popover is open
+    t9_text_adopt(kb);
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+    kb->alloc_audit.warm = true;
+#endif
+}
+
+/**
+ * Get the area invalidated by the last keyboard operation (key press, long-press, popover or
+ * candidate selection, mode change). Everything invalidated on the display from the start of
+ * that operation until now is counted, including the deferred press/release redraws of LVGL.
+ * Needs LV_KEYBOARD_T9_USE_DIRTY_REPORT, otherwise the report is all zero.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param dirty Receives the report
+ */
+void lv_keyboard_t9_get_dirty(lv_obj_t *keyboard, lv_keyboard_t9_dirty_t *dirty)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (dirty == NULL)
         return;
+    lv_memzero(dirty, sizeof(*dirty));
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+    if (kb)
+        *dirty = kb->dirty;
+#else
+    LV_UNUSED(kb);
+#endif
+}
 
-    // If in Number mode, no cycling, just add the char
-    if (t9_mode == T9_MODE_NUMBERS)
-    {
-        char out[2] = {chars[0], '\0'};
-        lv_textarea_add_text(linked_ta, out);
+/**
+ * Get the runtime counters of the keyboard, to tell the keyboard work apart from the
+ * application redraws. Handler times use LV_KEYBOARD_T9_TIME_US, which only has the
+ * lv_tick resolution unless it is defined (esp_timer is used on ESP-IDF).
+ * Needs LV_KEYBOARD_T9_USE_STATS, otherwise the counters are all zero.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param stats Receives the counters
+ */
+void lv_keyboard_t9_get_stats(lv_obj_t *keyboard, lv_keyboard_t9_stats_t *stats)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (stats == NULL)
         return;
-    }
-    // Cycling logic
-    uint32_t now = lv_tick_get();
-    // if key is different from "previous key" or timeout expired, reset cycle index
-    if (btn_id != t9_btn_last_pressed || now - t9_btn_last_press_time[char_idx] > t9_cycle_timeout_ms)
+    lv_memzero(stats, sizeof(*stats));
+#if LV_KEYBOARD_T9_USE_STATS
+    if (kb)
     {
-        t9_btn_cycle_idx[char_idx] = 0;
-        t9_btn_cycle_idx[t9_btn_last_pressed] = 0; // Restart Cycle Index for previous key
+        *stats = kb->stats;
+        if (kb->stats.handler_cnt)
+            stats->handler_avg_us = (uint32_t)(kb->handler_total_us / kb->stats.handler_cnt);
     }
-    else
+#else
+    LV_UNUSED(kb);
+#endif
+}
+
+/**
+ * Restart the runtime counters of the keyboard from zero.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ */
+void lv_keyboard_t9_reset_stats(lv_obj_t *keyboard)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        t9_btn_cycle_idx[char_idx]++;
-        if (chars[t9_btn_cycle_idx[char_idx]] == '\0')
-            t9_btn_cycle_idx[char_idx] = 0;
-        // Remove last char if cycling
-        lv_textarea_delete_char(linked_ta);
+        LV_LOG_WARN("lv_keyboard_t9_reset_stats: keyboard is NULL");
+        return;
     }
-    t9_btn_last_pressed = btn_id;
-    char out[2] = {chars[t9_btn_cycle_idx[char_idx]], '\0'};
-    lv_textarea_add_text(linked_ta, out);
-    t9_btn_last_press_time[char_idx] = now;
+#if LV_KEYBOARD_T9_USE_STATS
+    lv_memzero(&kb->stats, sizeof(kb->stats));
+    kb->handler_total_us = 0;
+#endif
 }
 
-// --- Popover logic ---
-
-// Use max symbol count for buffer size
-#define T9_POPOVER_MAX_SYMBOLS 40
-static const char *t9_popover_map[T9_POPOVER_MAX_SYMBOLS + 2]; // max symbols + \n + NULL
-static char t9_popover_buf[T9_POPOVER_MAX_SYMBOLS][2];
-
 /**
- * Event callback for popover buttonmatrix selection.
- * Inserts the selected character into the linked textarea and closes the popover.
+ * Get the allocations made inside the event handlers of the keyboard, as reported by the allocator
+ * of the application with lv_keyboard_t9_alloc_audit_hook. Once the keyboard is warmed up
+ * (lv_keyboard_t9_warm_up), any allocation is a violation: it is logged, and asserted with
+ * T9_ALLOC_AUDIT_ASSERT. Needs LV_KEYBOARD_T9_USE_ALLOC_AUDIT, otherwise the report is all zero.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param audit Receives the report
  */
-static void t9_popover_event_cb(lv_event_t *e)
+void lv_keyboard_t9_get_alloc_audit(lv_obj_t *keyboard, lv_keyboard_t9_alloc_audit_t *audit)
 {
-    lv_obj_t *popover = lv_event_get_target(e);
-    uint16_t btn_id = lv_buttonmatrix_get_selected_button(popover);
-    const char *txt = lv_buttonmatrix_get_button_text(popover, btn_id);
-    if (!txt || !linked_ta)
-        return;
-    if (lv_strcmp(txt, "\n") == 0)
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (audit == NULL)
         return;
-    lv_textarea_add_text(linked_ta, txt);
-    lv_obj_del(popover);
-    t9_popover = NULL;
+    lv_memzero(audit, sizeof(*audit));
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+    if (kb)
+        *audit = kb->alloc_audit;
+#else
+    LV_UNUSED(kb);
+#endif
 }
 
 /**
- * Show a popover with given characters for selection.
- * It is called when a long-press is detected on a T9 button.
+ * Restart the allocation audit of the keyboard from zero, it stays warm if it was.
  *
- * @param event LVGL event pointer
+ * @param keyboard Pointer to the T9 keyboard object
  */
-static void t9_btnmatrix_longpress_cb(lv_event_t *e)
+void lv_keyboard_t9_reset_alloc_audit(lv_obj_t *keyboard)
 {
-    lv_obj_t *btnmatrix = lv_event_get_target(e);
-    uint16_t btn_id = lv_buttonmatrix_get_selected_button(btnmatrix);
-
-    int char_idx = get_btn_char_idx(btn_id / T9_KEYBOARD_COLS, btn_id % T9_KEYBOARD_COLS);
-
-    //delete previous character in tarea
-    if (linked_ta)
-        lv_textarea_delete_char(linked_ta);
-
-    // Disable popover in Number mode
-    if (t9_mode == T9_MODE_NUMBERS)
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
     {
-        LV_LOG_INFO("Long-press: popover disabled in Number mode");
+        LV_LOG_WARN("lv_keyboard_t9_reset_alloc_audit: keyboard is NULL");
         return;
     }
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+    bool warm = kb->alloc_audit.warm;
+    lv_memzero(&kb->alloc_audit, sizeof(kb->alloc_audit));
+    kb->alloc_audit.warm = warm;
+#endif
+}
 
-    bool is_symbol_btn = (char_idx == 0 || char_idx == 9); // 1 or 0
-
-    const char *chars = NULL;
-    if (char_idx == 0)
-    {
-        chars = t9_btn_symbols_1;
-    }
-    else if (char_idx == 9)
-    {
-        chars = t9_btn_symbols_0;
-    }
-    else if (t9_mode == T9_MODE_UPPER)
-    {
-        chars = t9_btn_chars_upper[char_idx];
-    }
-    else
-    {
-        chars = t9_btn_chars_lower[char_idx];
-    }
-    LV_LOG_INFO("Long-press: chars='%s'", chars ? chars : "NULL");
-    if (!chars || chars[0] == '\0')
+/**
+ * Replace the character before the cursor of a textarea.
+ *
+ * When the new character has the same encoded size as the old one the label buffer is
+ * patched in place and refreshed once (no reallocation, one relayout and one redraw).
+ * Password mode, accepted chars filters and size changes fall back to delete + add.
+ * Note that the fast path does not send LV_EVENT_INSERT, only LV_EVENT_VALUE_CHANGED.
+ *
+ * @param ta Pointer to the textarea
+ * @param txt One UTF-8 encoded character
+ */
+void lv_keyboard_t9_textarea_replace_char(lv_obj_t *ta, const char *txt)
+{
+    if (ta == NULL || txt == NULL)
     {
-        LV_LOG_INFO("Long-press: chars is NULL or empty");
+        LV_LOG_WARN("lv_keyboard_t9_textarea_replace_char: ta or txt is NULL");
         return;
     }
-    // Clear buffer
-    for (int i = 0; i < T9_POPOVER_MAX_SYMBOLS; i++)
+    uint32_t pos = lv_textarea_get_cursor_pos(ta);
+    if (pos == 0)
     {
-        t9_popover_buf[i][0] = '\0';
-        t9_popover_buf[i][1] = '\0';
-        t9_popover_map[i] = NULL;
+        // Nothing to replace before the cursor
+        lv_textarea_add_text(ta, txt);
+        return;
     }
-    // Build popover map with 4 elements per row, no trailing linebreak
-    int idx = 0;
-    int col_count = 0;
-    int last_newline_idx = -1;
-    for (int i = 0; chars[i] != '\0' && idx < T9_POPOVER_MAX_SYMBOLS; i++)
+    if (!lv_textarea_get_password_mode(ta) && lv_textarea_get_accepted_chars(ta) == NULL)
     {
-        t9_popover_buf[i][0] = chars[i];
-        t9_popover_buf[i][1] = '\0';
-        t9_popover_map[idx++] = t9_popover_buf[i];
-        col_count++;
-        if (col_count == 4)
+        lv_obj_t *label = lv_textarea_get_label(ta);
+        char *text = lv_label_get_text(label);
+        uint32_t start = lv_text_encoded_get_byte_id(text, pos - 1);
+        uint32_t end = lv_text_encoded_get_byte_id(text, pos);
+        size_t len = lv_strlen(txt);
+        if (len == end - start)
         {
-            t9_popover_map[idx++] = "\n";
-            last_newline_idx = idx - 1;
-            col_count = 0;
+            if (lv_memcmp(&text[start], txt, len) != 0)
+            {
+                lv_memcpy(&text[start], txt, len);
+                lv_label_set_text(label, NULL); // Refresh with its own (same size) buffer
+                // Move the cursor back and forth so its area follows the new glyph width
+                lv_textarea_set_cursor_pos(ta, (int32_t)pos - 1);
+                lv_textarea_set_cursor_pos(ta, (int32_t)pos);
+                lv_obj_send_event(ta, LV_EVENT_VALUE_CHANGED, NULL);
+            }
+            return;
         }
-        LV_LOG_INFO("Long-press: popover label[%d]='%s'", i, t9_popover_buf[i]);
     }
-    // Remove trailing linebreak if present
-    if (col_count == 0 && last_newline_idx == idx - 1)
+    lv_textarea_delete_char(ta);
+    lv_textarea_add_text(ta, txt);
+}
+
+/**
+ * Delete characters before the cursor of a textarea.
+ *
+ * Several characters are cut from the label buffer in place and refreshed once (one relayout and
+ * one redraw instead of one per character). Like lv_keyboard_t9_textarea_replace_char, this fast
+ * path only sends LV_EVENT_VALUE_CHANGED. A single character, and password mode, go through
+ * lv_textarea_delete_char.
+ *
+ * @param ta Pointer to the textarea
+ * @param cnt Characters to delete, clamped to the cursor position
+ */
+void lv_keyboard_t9_textarea_delete_chars(lv_obj_t *ta, uint32_t cnt)
+{
+    if (ta == NULL)
     {
-        idx--; // Remove last newline
+        LV_LOG_WARN("lv_keyboard_t9_textarea_delete_chars: ta is NULL");
+        return;
     }
-    t9_popover_map[idx] = NULL;
-    LV_LOG_INFO("Long-press: popover map built, count=%d", idx);
-    // Create popover as child of keyboard object
-    lv_obj_t *keyboard = lv_obj_get_parent(btnmatrix);
-    lv_obj_update_layout(keyboard); // Ensure parent size is up-to-date
-    int popover_w = lv_obj_get_width(keyboard) * 90 / 100;
-    int popover_h = lv_obj_get_height(keyboard) * 90 / 100;
-    if (is_symbol_btn == false)
+    uint32_t pos = lv_textarea_get_cursor_pos(ta);
+    if (cnt > pos)
+        cnt = pos;
+    if (cnt > 1 && !lv_textarea_get_password_mode(ta))
     {
-        // change the height to something smaller
-        popover_h = lv_obj_get_height(keyboard) * 33 / 100;
+        lv_obj_t *label = lv_textarea_get_label(ta);
+        char *text = lv_label_get_text(label);
+        uint32_t start = lv_text_encoded_get_byte_id(text, pos - cnt);
+        uint32_t end = lv_text_encoded_get_byte_id(text, pos);
+        bool empty = start == 0 && text[end] == '\0';
+        lv_memmove(&text[start], &text[end], lv_strlen(&text[end]) + 1);
+        lv_label_set_text(label, NULL); // Refresh with its own (shorter) buffer, text may move
+        lv_textarea_set_cursor_pos(ta, (int32_t)(pos - cnt));
+        if (empty)
+            lv_obj_invalidate(ta); // Show the placeholder
+        lv_obj_send_event(ta, LV_EVENT_VALUE_CHANGED, NULL);
+        return;
     }
-    t9_popover = lv_buttonmatrix_create(keyboard);
-    lv_obj_set_size(t9_popover, popover_w, popover_h); // Fill most of parent
-    lv_obj_center(t9_popover);
-    // lv_obj_set_style_bg_color(t9_popover, lv_color_hex(0x222222), 0);
-    lv_obj_set_style_border_color(t9_popover, lv_color_hex(0x8888ff), 0);
-    lv_obj_set_style_border_width(t9_popover, 2, 0);
-    lv_obj_set_style_pad_all(t9_popover, 6, 0);
-    lv_obj_set_style_pad_row(t9_popover, 8, 0);    // Comfortable row spacing
-    lv_obj_set_style_pad_column(t9_popover, 8, 0); // Comfortable column spacing
-
-    lv_buttonmatrix_set_map(t9_popover, t9_popover_map);
-    //Disable "repeat" for popover buttons
-    lv_buttonmatrix_set_button_ctrl_all(t9_popover, LV_BUTTONMATRIX_CTRL_NO_REPEAT);
-
-    lv_obj_add_event_cb(t9_popover, t9_popover_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    for (uint32_t i = 0; i < cnt; i++)
+        lv_textarea_delete_char(ta);
 }
+
+// Store the callback in the keyboard state
+void lv_keyboard_t9_set_event_cb(lv_obj_t *keyboard, lv_keyboard_t9_event_cb_t cb)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_set_event_cb: keyboard is NULL");
+        return;
+    }
+    kb->event_cb = cb;
+}
+
+/**
+ * Get the action of a button of the keyboard matrix.
+ * Returns NULL if btn_id is not a button (e.g. LV_BUTTONMATRIX_BUTTON_NONE).
+ */
+static const t9_btn_action_t *t9_get_btn_action(const t9_keyboard_t *kb, uint32_t btn_id)
+{
+    if (btn_id >= kb->layout->btn_cnt)
+        return NULL;
+    return &t9_key_actions[kb->layout->keys[btn_id]];
+}
+
+// --- Dirty area report ---
+
+// Start a new keyboard operation, the report restarts from zero
+static void t9_dirty_begin(t9_keyboard_t *kb)
+{
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+    uint32_t op_id = kb->dirty.op_id + 1;
+    lv_memzero(&kb->dirty, sizeof(kb->dirty));
+    kb->dirty.op_id = op_id;
+#else
+    LV_UNUSED(kb);
+#endif
+}
+
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+static void t9_display_invalidate_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    const lv_area_t *area = lv_event_get_param(e);
+    if (area == NULL)
+        return;
+    if (kb->dirty.area_cnt == 0)
+        kb->dirty.bbox = *area;
+    else
+        lv_area_join(&kb->dirty.bbox, &kb->dirty.bbox, area);
+    kb->dirty.area_cnt++;
+    kb->dirty.area_px += lv_area_get_size(area);
+}
+#endif
+
+#if LV_KEYBOARD_T9_USE_STATS
+// Account one event handler run
+static void t9_stats_handler_done(t9_keyboard_t *kb, uint32_t us)
+{
+    kb->stats.handler_cnt++;
+    kb->handler_total_us += us;
+    if (us > kb->stats.handler_max_us)
+        kb->stats.handler_max_us = us;
+}
+#endif
+
+// --- Textarea mutations, every keyboard edit of the linked textarea goes through these ---
+// In place in the reserved text buffer when there is one (lv_keyboard_t9_text.c), else through LVGL
+
+static void t9_ta_add_text(t9_keyboard_t *kb, const char *txt)
+{
+    T9_TRACE_BEGIN(LV_KEYBOARD_T9_TRACE_TEXT);
+    if (!t9_text_insert(kb, "", txt, lv_strlen(txt)))
+        lv_textarea_add_text(kb->ta, txt);
+    T9_STAT_INC(kb, text_mutations);
+    T9_TRACE_END(LV_KEYBOARD_T9_TRACE_TEXT);
+}
+
+/**
+ * Insert pre (NUL terminated) then len bytes of UTF-8 text with no NUL, as one edit: in place with a
+ * reserved text buffer, else joined on the stack (or the heap from T9_INSERT_STACK_SIZE bytes) for
+ * lv_textarea_add_text.
+ * Returns false if out of memory, nothing is inserted.
+ */
+static bool t9_ta_add_joined(t9_keyboard_t *kb, const char *pre, const char *utf8, size_t len)
+{
+    T9_TRACE_BEGIN(LV_KEYBOARD_T9_TRACE_TEXT);
+    if (!t9_text_insert(kb, pre, utf8, len))
+    {
+        size_t pre_len = lv_strlen(pre);
+        size_t total = pre_len + len;
+        char stack_buf[T9_INSERT_STACK_SIZE];
+        char *buf = total < sizeof(stack_buf) ? stack_buf : lv_malloc(total + 1);
+        if (buf == NULL)
+        {
+            LV_LOG_WARN("lv_keyboard_t9_insert_text: out of memory");
+            T9_TRACE_END(LV_KEYBOARD_T9_TRACE_TEXT);
+            return false;
+        }
+        lv_memcpy(buf, pre, pre_len);
+        lv_memcpy(buf + pre_len, utf8, len);
+        buf[total] = '\0';
+        lv_textarea_add_text(kb->ta, buf);
+        if (buf != stack_buf)
+            lv_free(buf);
+    }
+    T9_STAT_INC(kb, text_mutations);
+    T9_TRACE_END(LV_KEYBOARD_T9_TRACE_TEXT);
+    return true;
+}
+
+static void t9_ta_delete_chars(t9_keyboard_t *kb, uint32_t cnt)
+{
+    T9_TRACE_BEGIN(LV_KEYBOARD_T9_TRACE_TEXT);
+    if (!t9_text_delete(kb, cnt))
+        lv_keyboard_t9_textarea_delete_chars(kb->ta, cnt);
+    T9_STAT_INC(kb, text_mutations);
+    T9_TRACE_END(LV_KEYBOARD_T9_TRACE_TEXT);
+}
+
+static void t9_ta_clear(t9_keyboard_t *kb)
+{
+    T9_TRACE_BEGIN(LV_KEYBOARD_T9_TRACE_TEXT);
+    if (!t9_text_clear(kb))
+        lv_textarea_set_text(kb->ta, "");
+    T9_STAT_INC(kb, text_mutations);
+    T9_TRACE_END(LV_KEYBOARD_T9_TRACE_TEXT);
+}
+
+// Chars from the cursor back to the start of the word before it, the spaces after that word included
+static uint32_t t9_ta_word_chars(const t9_keyboard_t *kb)
+{
+    const char *text = lv_textarea_get_text(kb->ta);
+    uint32_t i = lv_text_encoded_get_byte_id(text, lv_textarea_get_cursor_pos(kb->ta));
+    uint32_t cnt = 0;
+    while (i > 0 && (text[i - 1] == ' ' || text[i - 1] == '\n'))
+    {
+        i--;
+        cnt++;
+    }
+    while (i > 0 && text[i - 1] != ' ' && text[i - 1] != '\n')
+    {
+        i--;
+        if ((text[i] & 0xC0) != 0x80) // First byte of a UTF-8 char
+            cnt++;
+    }
+    return cnt;
+}
+
+static void t9_ta_replace_char(t9_keyboard_t *kb, const char *txt)
+{
+    T9_TRACE_BEGIN(LV_KEYBOARD_T9_TRACE_TEXT);
+    if (!t9_text_replace_char(kb, txt))
+        lv_keyboard_t9_textarea_replace_char(kb->ta, txt);
+    T9_STAT_INC(kb, text_mutations);
+    T9_TRACE_END(LV_KEYBOARD_T9_TRACE_TEXT);
+}
+
+// --- Composition logic ---
+
+// Write the pending char to the textarea
+static void t9_compose_commit(t9_keyboard_t *kb)
+{
+    if (kb->pending[0] == '\0')
+        return;
+    if (kb->ta)
+    {
+        t9_ta_add_text(kb, kb->pending);
+        T9_STAT_INC(kb, commits);
+    }
+    t9_compose_discard(kb);
+}
+
+// Drop the pending char without writing it
+static void t9_compose_discard(t9_keyboard_t *kb)
+{
+    kb->pending[0] = '\0';
+    if (kb->preedit)
+        lv_obj_add_flag(kb->preedit, LV_OBJ_FLAG_HIDDEN);
+    if (kb->commit_timer)
+        lv_timer_pause(kb->commit_timer);
+}
+
+static void t9_compose_timer_cb(lv_timer_t *timer)
+{
+    t9_keyboard_t *kb = lv_timer_get_user_data(timer);
+    T9_AUDIT_BEGIN(kb);
+    t9_compose_commit(kb);
+    T9_AUDIT_END(kb, LV_KEYBOARD_T9_TRACE_TEXT);
+}
+
+// Make txt the pending char and (re)start the commit timeout
+static void t9_compose_set(t9_keyboard_t *kb, const char *txt)
+{
+    lv_strncpy(kb->pending, txt, sizeof(kb->pending)); // Terminated, like strlcpy
+    lv_label_set_text_static(kb->preedit, kb->pending);
+    lv_obj_remove_flag(kb->preedit, LV_OBJ_FLAG_HIDDEN);
+
+    if (kb->commit_timer == NULL)
+        return; // Out of memory when compose mode was enabled, committed by the next key
+    lv_timer_set_period(kb->commit_timer, t9_cycle_timeout(kb));
+    lv_timer_reset(kb->commit_timer);
+    lv_timer_resume(kb->commit_timer);
+}
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+// --- Predictive logic ---
+
+// Forget the word being composed, what is in the textarea stays (commit)
+static void t9_pred_reset(t9_keyboard_t *kb)
+{
+    if (kb->pred_len > 0)
+        T9_STAT_INC(kb, commits);
+    kb->pred_len = 0;
+    kb->pred_matched = 0;
+    kb->pred_path[0] = T9_DICT_ROOT;
+    kb->pred_candidate_count = 0;
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+    kb->rank_seq = 0; // A result still in flight is for a sequence that is gone
+#endif
+    if (kb->pred_bar)
+        lv_obj_add_flag(kb->pred_bar, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Append a digit (2..9), moving the trie cursor one node down while the sequence still matches
+static void t9_pred_push(t9_keyboard_t *kb, uint8_t digit)
+{
+    if (kb->pred_len == T9_PRED_MAX_DEPTH)
+        t9_pred_reset(kb); // Too long for a dictionary word, commit and start over
+    if (kb->pred_matched == kb->pred_len)
+    {
+        uint32_t child = t9_dict_child(kb->dict, kb->pred_path[kb->pred_matched], digit);
+        if (child != T9_DICT_NONE)
+            kb->pred_path[++kb->pred_matched] = child;
+    }
+    kb->pred_digits[kb->pred_len++] = digit;
+}
+
+// Remove the last digit, the cursor of the shorter sequence is still in the path
+static void t9_pred_pop(t9_keyboard_t *kb)
+{
+    if (kb->pred_len == 0)
+        return;
+    kb->pred_len--;
+    if (kb->pred_matched > kb->pred_len)
+        kb->pred_matched = kb->pred_len;
+}
+
+/**
+ * Show the candidates on the bar. The map always has T9_PRED_CANDIDATES buttons so LVGL keeps its
+ * button arrays, the unused slots are empty, hidden and shrunk to the smallest width.
+ */
+static void t9_pred_update_bar(t9_keyboard_t *kb)
+{
+    if (kb->pred_bar == NULL)
+        return;
+    uint8_t count = kb->pred_candidate_count;
+    if (count == 0)
+    {
+        lv_obj_add_flag(kb->pred_bar, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    for (uint32_t i = count; i < T9_PRED_CANDIDATES; i++)
+        kb->pred_candidates[i] = "";
+    kb->pred_candidates[T9_PRED_CANDIDATES] = NULL; // End marker
+    if (kb->pred_bar_cnt != count)
+    {
+        for (uint32_t i = 0; i < T9_PRED_CANDIDATES; i++)
+        {
+            lv_buttonmatrix_set_button_width(kb->pred_bar, i, i < count ? 15 : 1);
+            if (i < count)
+                lv_buttonmatrix_clear_button_ctrl(kb->pred_bar, i, LV_BUTTONMATRIX_CTRL_HIDDEN);
+            else
+                lv_buttonmatrix_set_button_ctrl(kb->pred_bar, i, LV_BUTTONMATRIX_CTRL_HIDDEN);
+        }
+        kb->pred_bar_cnt = count;
+    }
+    lv_buttonmatrix_set_map(kb->pred_bar, kb->pred_candidates); // Same button count, the ctrl bits are kept
+    T9_STAT_INC(kb, map_rebuilds);
+    lv_obj_remove_flag(kb->pred_bar, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Case insensitive ASCII compare, a learned word and its dictionary entry are one candidate
+static bool t9_pred_same_word(const char *a, const char *b)
+{
+    for (; *a != '\0' && *b != '\0'; a++, b++)
+    {
+        char ca = (*a >= 'A' && *a <= 'Z') ? (char)(*a - 'A' + 'a') : *a;
+        char cb = (*b >= 'A' && *b <= 'Z') ? (char)(*b - 'A' + 'a') : *b;
+        if (ca != cb)
+            return false;
+    }
+    return *a == *b;
+}
+
+/**
+ * Exact matches of a digit sequence: learned words first, then the dictionary ones.
+ * Pure function of its arguments, also called by the ranking worker (lv_keyboard_t9_rank.c).
+ *
+ * @param node Trie node reached by the sequence, or by its matched prefix if not exact
+ * @param exact The whole sequence is inside the trie
+ * @param learn Learned words, or NULL
+ * @param out Receives up to T9_PRED_CANDIDATES word pointers
+ * @return Number of candidates
+ */
+uint32_t t9_pred_rank(const t9_dict_t *dict, uint32_t node, bool exact, const t9_learn_t *learn,
+                      const uint8_t *digits, uint8_t len, const char **out)
+{
+    uint32_t cnt = 0;
+    if (len == 0)
+        return 0;
+    if (learn)
+        cnt = t9_learn_get_candidates(learn, digits, len, out, T9_PRED_CANDIDATES);
+    if (!exact || cnt == T9_PRED_CANDIDATES)
+        return cnt;
+
+    const char *words[T9_PRED_CANDIDATES];
+    uint32_t word_cnt = t9_dict_get_candidates(dict, node, words, T9_PRED_CANDIDATES);
+    uint32_t learned = cnt;
+    for (uint32_t i = 0; i < word_cnt && cnt < T9_PRED_CANDIDATES; i++)
+    {
+        bool dup = false;
+        for (uint32_t j = 0; j < learned && !dup; j++)
+            dup = t9_pred_same_word(words[i], out[j]);
+        if (!dup)
+            out[cnt++] = words[i];
+    }
+    return cnt;
+}
+
+static void t9_pred_get_candidates(t9_keyboard_t *kb)
+{
+    kb->pred_candidate_count = (uint8_t)t9_pred_rank(kb->dict, kb->pred_path[kb->pred_matched],
+                                                     kb->pred_matched == kb->pred_len, kb->learn, kb->pred_digits,
+                                                     kb->pred_len, kb->pred_candidates);
+}
+
+/**
+ * Replace the previously composed chars in the textarea with the first word_len chars of word,
+ * the remaining digits show the first letter of their key.
+ *
+ * @param prev_len Number of composed chars currently in the textarea
+ */
+static void t9_pred_write(t9_keyboard_t *kb, uint8_t prev_len, const char *word, uint8_t word_len)
+{
+    char out[T9_PRED_MAX_DEPTH + 1];
+    for (uint8_t i = 0; i < kb->pred_len; i++)
+    {
+        out[i] = (word && i < word_len) ? word[i] : t9_pred_fallback[kb->pred_digits[i] - 2];
+    }
+    out[kb->pred_len] = '\0';
+
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+    if (prev_len == kb->pred_len && lv_strcmp(out, kb->pred_text) == 0)
+        return; // The ranked word starts like the prefix already shown
+    lv_memcpy(kb->pred_text, out, kb->pred_len + 1);
+#endif
+    if (kb->ta)
+    {
+        t9_ta_delete_chars(kb, prev_len);
+        t9_ta_add_text(kb, out);
+    }
+}
+
+/**
+ * Show the best match of the current sequence in the textarea and its candidates in the bar.
+ * Exact matches win, otherwise the prefix of the best longer word is shown, and digits past the end
+ * of the trie show the first letter of their key. With the asynchronous ranking the best prefix is
+ * shown first and the exact matches replace it in t9_pred_rank_done.
+ *
+ * @param prev_len Number of composed chars currently in the textarea
+ */
+static void t9_pred_render(t9_keyboard_t *kb, uint8_t prev_len)
+{
+    const char *word = NULL;
+    uint8_t word_len = 0; // Leading chars of word that match the sequence
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+    if (kb->pred_len > 0 && t9_rank_post(kb))
+    {
+        // The bar keeps the previous candidates until the result, but they can not be picked
+        kb->pred_candidate_count = 0;
+        if (kb->pred_matched > 0)
+            word = t9_dict_get_best(kb->dict, kb->pred_path[kb->pred_matched]);
+        t9_pred_write(kb, prev_len, word, kb->pred_matched);
+        return;
+    }
+    kb->rank_seq = 0; // Ranked here, a result still in flight is older
+#endif
+    t9_pred_get_candidates(kb);
+    if (kb->pred_candidate_count > 0)
+    {
+        word = kb->pred_candidates[0];
+        word_len = kb->pred_len;
+    }
+    else if (kb->pred_matched > 0)
+    {
+        word = t9_dict_get_best(kb->dict, kb->pred_path[kb->pred_matched]);
+        word_len = kb->pred_matched;
+    }
+    t9_pred_write(kb, prev_len, word, word_len);
+    t9_pred_update_bar(kb);
+}
+
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+/**
+ * Apply the ranking result of the current sequence (called from lv_keyboard_t9_rank.c on the LVGL thread).
+ *
+ * @param words Ranked candidates, copied into the keyboard
+ * @param count Number of candidates
+ */
+void t9_pred_rank_done(t9_keyboard_t *kb, char (*words)[T9_PRED_MAX_DEPTH + 1], uint8_t count)
+{
+    T9_HANDLER_BEGIN(kb, LV_KEYBOARD_T9_TRACE_RANK);
+    t9_dirty_begin(kb);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        lv_memcpy(kb->pred_words[i], words[i], sizeof(kb->pred_words[i]));
+        kb->pred_candidates[i] = kb->pred_words[i];
+    }
+    kb->pred_candidate_count = count;
+    if (count > 0)
+        t9_pred_write(kb, kb->pred_len, kb->pred_candidates[0], kb->pred_len);
+    t9_pred_update_bar(kb);
+    T9_HANDLER_END(kb, LV_KEYBOARD_T9_TRACE_RANK);
+}
+#endif
+
+/**
+ * Replace the composed word with a candidate of the bar and commit it with a space.
+ *
+ * @param btn_id Button of the candidate bar
+ * @param now Time of the selection in ms
+ */
+static void t9_pred_select(t9_keyboard_t *kb, uint32_t btn_id, uint32_t now)
+{
+    t9_input_record(kb, LV_KEYBOARD_T9_INPUT_CANDIDATE, btn_id, now);
+    T9_HANDLER_BEGIN(kb, LV_KEYBOARD_T9_TRACE_POPOVER);
+    t9_dirty_begin(kb);
+    if (btn_id < kb->pred_candidate_count && kb->ta)
+    {
+        t9_ta_delete_chars(kb, kb->pred_len);
+        t9_ta_add_text(kb, kb->pred_candidates[btn_id]);
+        t9_ta_add_text(kb, " ");
+        t9_pred_reset(kb);
+    }
+    T9_HANDLER_END(kb, LV_KEYBOARD_T9_TRACE_POPOVER);
+}
+
+// Event callback for the candidate bar
+static void t9_pred_event_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    lv_obj_t *bar = lv_event_get_target(e);
+    t9_pred_select(kb, lv_buttonmatrix_get_selected_button(bar), lv_tick_get());
+}
+
+#endif // LV_KEYBOARD_T9_USE_PREDICTIVE
+
+// Show the mode of the core after a switch from prev, committing any composed word and resizing
+// the matrix around the candidate bar
+static void t9_mode_changed(t9_keyboard_t *kb, t9_mode_t prev)
+{
+    t9_compose_commit(kb);
+    t9_pred_reset(kb);
+    bool was_predictive = (prev == T9_MODE_PREDICTIVE);
+    if (kb->btnmatrix == NULL)
+        return;
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    if (kb->core.mode == T9_MODE_PREDICTIVE)
+    {
+        lv_obj_set_height(kb->btnmatrix, lv_pct(100 - T9_PRED_BAR_PCT));
+        lv_obj_align(kb->btnmatrix, LV_ALIGN_BOTTOM_MID, 0, 0);
+    }
+    else if (was_predictive)
+#else
+    if (was_predictive)
+#endif
+    {
+        lv_obj_set_height(kb->btnmatrix, lv_pct(100));
+        lv_obj_center(kb->btnmatrix);
+    }
+    t9_update_btnmatrix_labels(kb);
+    t9_key_cache_sync(kb); // Image of the new mode, LV_EVENT_SIZE_CHANGED syncs again around the candidate bar
+}
+
+// Switch mode, the one-shot shift is cleared (set again by the shift key after the switch)
+static void t9_apply_mode(t9_keyboard_t *kb, t9_mode_t mode)
+{
+    t9_mode_t prev = (t9_mode_t)kb->core.mode;
+    t9_core_set_mode(&kb->core, mode);
+    t9_mode_changed(kb, prev);
+}
+
+/**
+ * Invalidate a single button of the keyboard matrix, instead of the whole object. The buttons of a
+ * row have the same width, the cell is computed from the content area and the grid cell of the
+ * layout, grown by half the gaps to absorb LVGL rounding.
+ */
+static void t9_invalidate_button(const t9_keyboard_t *kb, uint32_t btn_id)
+{
+    lv_obj_t *btnmatrix = kb->btnmatrix;
+    const t9_layout_cell_t *cell = &kb->layout->cells[btn_id];
+    int32_t rows = kb->layout->row_cnt;
+    lv_area_t content;
+    lv_obj_get_content_coords(btnmatrix, &content);
+    int32_t pad_row = lv_obj_get_style_pad_row(btnmatrix, LV_PART_MAIN);
+    int32_t pad_col = lv_obj_get_style_pad_column(btnmatrix, LV_PART_MAIN);
+    int32_t btn_w = (lv_area_get_width(&content) - pad_col * (cell->cols - 1)) / cell->cols;
+    int32_t btn_h = (lv_area_get_height(&content) - pad_row * (rows - 1)) / rows;
+    int32_t row = cell->row;
+    int32_t col = cell->col;
+
+    lv_area_t area;
+    area.x1 = content.x1 + col * (btn_w + pad_col);
+    area.y1 = content.y1 + row * (btn_h + pad_row);
+    area.x2 = area.x1 + btn_w - 1;
+    area.y2 = area.y1 + btn_h - 1;
+    lv_area_increase(&area, pad_col / 2 + 1, pad_row / 2 + 1);
+    lv_obj_invalidate_area(btnmatrix, &area);
+}
+
+/**
+ * Update the buttonmatrix labels for the current mode.
+ * The map array stays the same, only entries whose text changes are swapped and their
+ * buttons invalidated, so there is no reallocation, relayout or full redraw.
+ */
+static void t9_update_btnmatrix_labels(t9_keyboard_t *kb)
+{
+    T9_TRACE_BEGIN(LV_KEYBOARD_T9_TRACE_LABELS);
+    bool changed = false;
+    const char *const *map = kb->layout->maps[kb->core.mode];
+    const char *const *labels = kb->core.mode == T9_MODE_NUMBERS ? NULL : kb->core.charset->labels[kb->core.mode == T9_MODE_UPPER];
+    uint32_t btn_id = 0;
+    for (uint32_t i = 0; map[i] != NULL; i++)
+    {
+        if (map[i][0] == '\n')
+            continue;
+        const char *label = map[i];
+        const t9_btn_action_t *action = t9_get_btn_action(kb, btn_id);
+        if (labels && action->action == T9_ACTION_CHAR)
+            label = labels[action->char_idx];
+        if (kb->map[i] != label && lv_strcmp(kb->map[i], label) != 0)
+        {
+            kb->map[i] = label;
+            t9_invalidate_button(kb, btn_id);
+            changed = true;
+        }
+        btn_id++;
+    }
+    if (changed)
+        T9_STAT_INC(kb, map_rebuilds);
+    T9_TRACE_END(LV_KEYBOARD_T9_TRACE_LABELS);
+}
+
+/**
+ * Give the map of the layout to the keyboard matrix and set the ctrl bits of its buttons: no repeat
+ * but on backspace, helper keys underlined (see t9_style_helper). Only a layout with another button
+ * count makes LVGL reallocate its button arrays, mode switches keep them (t9_update_btnmatrix_labels).
+ */
+static void t9_layout_apply(t9_keyboard_t *kb)
+{
+    const t9_layout_t *layout = kb->layout;
+    lv_memcpy(kb->map, layout->maps[kb->core.mode], (layout->btn_cnt + layout->row_cnt) * sizeof(kb->map[0]));
+    lv_buttonmatrix_set_map(kb->btnmatrix, kb->map);
+    lv_buttonmatrix_clear_button_ctrl_all(kb->btnmatrix, LV_BUTTONMATRIX_CTRL_CHECKED);
+    lv_buttonmatrix_set_button_ctrl_all(kb->btnmatrix, LV_BUTTONMATRIX_CTRL_WIDTH_1 | LV_BUTTONMATRIX_CTRL_NO_REPEAT);
+    for (uint32_t i = 0; i < layout->btn_cnt; i++)
+    {
+        const t9_btn_action_t *action = t9_get_btn_action(kb, i);
+        if (action->action == T9_ACTION_BACKSPACE)
+            lv_buttonmatrix_clear_button_ctrl(kb->btnmatrix, i, LV_BUTTONMATRIX_CTRL_NO_REPEAT);
+        if (action->underline)
+            lv_buttonmatrix_set_button_ctrl(kb->btnmatrix, i, LV_BUTTONMATRIX_CTRL_CHECKED);
+    }
+    t9_update_btnmatrix_labels(kb); // Labels of the charset pack
+    t9_key_cache_invalidate(kb);
+}
+
+/*
+ * Start or continue a backspace hold: presses closer than T9_BACKSPACE_GAP_MS continue it until the
+ * key is released (a touch or keypad release ends it, a replayed trace only has the gaps).
+ * Returns how long backspace has been held, 0 on a new press.
+ */
+static uint32_t t9_backspace_hold(t9_keyboard_t *kb, uint32_t now)
+{
+    if (!kb->bs_held || now - kb->bs_last > T9_BACKSPACE_GAP_MS)
+    {
+        kb->bs_held = true;
+        kb->bs_start = now;
+    }
+    kb->bs_last = now;
+    return now - kb->bs_start;
+}
+
+// Delete before the cursor, a char, a word or everything depending on how long backspace is held
+static void t9_handle_backspace(t9_keyboard_t *kb, uint32_t hold)
+{
+    if (kb->bs_clear_ms && hold >= kb->bs_clear_ms)
+    {
+        t9_pred_reset(kb);
+        t9_ta_clear(kb);
+        return;
+    }
+    bool words = kb->bs_word_ms && hold >= kb->bs_word_ms;
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    if (kb->core.mode == T9_MODE_PREDICTIVE && kb->pred_len > 0)
+    {
+        if (words)
+        {
+            // The composed chars are the word, drop them all
+            uint8_t len = kb->pred_len;
+            t9_pred_reset(kb);
+            t9_ta_delete_chars(kb, len);
+            return;
+        }
+        // Drop the last digit of the composed word instead of a char
+        uint8_t prev_len = kb->pred_len;
+        t9_pred_pop(kb);
+        t9_pred_render(kb, prev_len);
+        return;
+    }
+#endif
+    uint32_t cnt = words ? t9_ta_word_chars(kb) : 1;
+    if (cnt)
+        t9_ta_delete_chars(kb, cnt);
+}
+
+// Apply an edit of the core to the textarea, or to the pending char while composing
+static void t9_apply_edit(t9_keyboard_t *kb, const t9_edit_t *edit, uint32_t hold)
+{
+    switch (edit->type)
+    {
+    case T9_EDIT_INSERT:
+        t9_compose_commit(kb);
+        if (kb->compose && edit->open)
+            t9_compose_set(kb, edit->text); // Only the preedit label changes while cycling, the textarea gets the char on commit
+        else
+            t9_ta_add_text(kb, edit->text);
+        break;
+    case T9_EDIT_REPLACE_LAST:
+        if (kb->compose)
+            t9_compose_set(kb, edit->text);
+        else
+            t9_ta_replace_char(kb, edit->text); // Swap the last char, one text mutation
+        T9_STAT_INC(kb, cycles);
+        break;
+    case T9_EDIT_DELETE:
+        t9_handle_backspace(kb, hold); // The core deletes a char, the hold may make it a word or everything
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * Handle a keyboard button press: character cycling, helper buttons, and mode switching.
+ * Shared by the touch (buttonmatrix) and the keypad (lv_keyboard_t9_feed_key) inputs. The multi-tap
+ * state machine is t9_core, the keyboard adds the predictive and composition modes and applies its edits.
+ *
+ * @param kb Keyboard state
+ * @param btn_id Pressed button of the keyboard matrix
+ * @param now Press time in ms, for the multi-tap timeout
+ * @return The lv_keyboard_t9_event_t of an OK or close press, -1 if none. The caller sends it once the
+ *         operation is accounted for: the application may delete the keyboard from its event callback.
+ */
+static int t9_handle_press(t9_keyboard_t *kb, uint32_t btn_id, uint32_t now)
+{
+    const t9_btn_action_t *action = t9_get_btn_action(kb, btn_id);
+
+    // Print btn_id
+    //LV_LOG_USER("t9_btnmatrix_event_cb: btn_id=%d", btn_id);
+
+    if (!action || !kb->ta)
+        return -1;
+
+    if(kb->popover) {
+        // If popover is open, ignore all button presses
+        return -1;
+    }
+    T9_STAT_INC(kb, presses);
+
+    uint32_t hold = 0;
+    if (action->action == T9_ACTION_BACKSPACE)
+        hold = t9_backspace_hold(kb, now);
+    else
+        kb->bs_held = false;
+
+    if (action->action == T9_ACTION_CHAR)
+    {
+        int char_idx = action->char_idx;
+        if (char_idx < 0 || char_idx >= T9_BUTTON_COUNT)
+            return -1;
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+        if (kb->core.mode == T9_MODE_PREDICTIVE)
+        {
+            if (char_idx >= 1 && char_idx <= 8)
+            {
+                // Letter keys move the trie cursor, one press per letter
+                t9_compose_commit(kb);
+                uint8_t prev_len = kb->pred_len;
+                t9_pred_push(kb, (uint8_t)(char_idx + 1));
+                t9_pred_render(kb, prev_len);
+                t9_core_end_cycle(&kb->core); // Never cycle over a composed char
+                return -1;
+            }
+            // Symbol keys commit the word and keep multi-tap cycling
+            t9_pred_reset(kb);
+        }
+#endif
+        if (kb->compose && kb->pending[0] == '\0')
+            t9_core_end_cycle(&kb->core); // The timer committed the char, this press starts a new one
+    }
+    else if (action->action != T9_ACTION_BACKSPACE)
+    {
+        t9_compose_commit(kb);
+        if (action->action == T9_ACTION_SPACE || action->action == T9_ACTION_OK || action->action == T9_ACTION_CLOSE)
+            t9_pred_reset(kb);
+    }
+
+    // The pending char was never written, a backspace just drops it
+    bool dropped = action->action == T9_ACTION_BACKSPACE && kb->pending[0] != '\0';
+    if (dropped)
+        t9_compose_discard(kb);
+
+    // Multi-tap state machine, the edits are applied once the mode it may have changed is shown
+    t9_mode_t prev = (t9_mode_t)kb->core.mode;
+    t9_edit_t edits[T9_CORE_EDITS_MAX];
+    t9_core_set_timeout(&kb->core, t9_cycle_timeout_ms);
+    uint32_t edit_cnt = t9_core_press(&kb->core, kb->layout->keys[btn_id], now, edits, T9_CORE_EDITS_MAX);
+    if (kb->core.mode != prev)
+        t9_mode_changed(kb, prev);
+    for (uint32_t i = 0; i < edit_cnt; i++)
+    {
+        if (edits[i].type == T9_EDIT_DELETE && dropped)
+            continue;
+        t9_apply_edit(kb, &edits[i], hold);
+    }
+
+    switch (action->action)
+    {
+    case T9_ACTION_OK:
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+        t9_learn_confirmed(kb);
+#endif
+        return LV_KEYBOARD_T9_EVENT_READY;
+    case T9_ACTION_CLOSE:
+        return LV_KEYBOARD_T9_EVENT_CANCEL;
+    default:
+        return -1;
+    }
+}
+
+// Run a press as one keyboard operation (dirty report, stats and trace)
+static void t9_do_press(t9_keyboard_t *kb, uint32_t btn_id, uint32_t now)
+{
+    t9_input_record(kb, LV_KEYBOARD_T9_INPUT_PRESS, btn_id, now);
+    T9_HANDLER_BEGIN(kb, LV_KEYBOARD_T9_TRACE_PRESS);
+    t9_dirty_begin(kb);
+    int event = t9_handle_press(kb, btn_id, now);
+    T9_HANDLER_END(kb, LV_KEYBOARD_T9_TRACE_PRESS);
+    if (event < 0)
+        return;
+#if LV_KEYBOARD_T9_USE_KEYPAD
+    if (kb->keypad_reading)
+    {
+        // LVGL is reading the keypad device, the callback may delete it: sent by the keypad timer
+        kb->keypad_event = (int8_t)event;
+        lv_timer_resume(kb->keypad_timer);
+        lv_timer_ready(kb->keypad_timer);
+        return;
+    }
+#endif
+    // Last, kb may be freed by the callback
+    if (kb->event_cb)
+        kb->event_cb(kb->btnmatrix, (lv_keyboard_t9_event_t)event);
+}
+
+// Event callback for buttonmatrix value changes (button presses)
+static void t9_btnmatrix_event_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    lv_obj_t *btnmatrix = lv_event_get_target(e);
+    t9_do_press(kb, lv_buttonmatrix_get_selected_button(btnmatrix), lv_tick_get());
+}
+
+// --- Popover logic ---
+
+// Hide the open popover, the object is kept for the next long-press
+static void t9_popover_close(t9_keyboard_t *kb)
+{
+    if (kb->popover == NULL)
+        return;
+    lv_obj_add_flag(kb->popover, LV_OBJ_FLAG_HIDDEN);
+    kb->popover = NULL;
+    kb->page_count = 0;
+}
+
+// Fill page_map with the chars of the current page, the cells past the last char stay empty
+static void t9_popover_build_page(t9_keyboard_t *kb)
+{
+    const lv_keyboard_t9_charset_t *cs = kb->core.charset;
+    uint32_t first = (uint32_t)kb->page * T9_POPOVER_PAGE_CELLS;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < T9_POPOVER_PAGE_CELLS; i++)
+    {
+        if (i > 0 && i % T9_POPOVER_PAGE_COLS == 0)
+            kb->page_map[n++] = "\n";
+        uint32_t c = first + i;
+        kb->page_map[n++] = c < kb->page_chars ? &cs->blob[cs->offs[kb->page_first + c]] : "";
+    }
+    lv_snprintf(kb->page_label, sizeof(kb->page_label), "%u/%u", (unsigned)kb->page + 1, (unsigned)kb->page_count);
+    kb->page_map[n++] = "\n";
+    kb->page_map[n++] = LV_SYMBOL_LEFT;
+    kb->page_map[n++] = kb->page_label;
+    kb->page_map[n++] = LV_SYMBOL_RIGHT;
+    kb->page_map[n] = NULL;
+}
+
+/**
+ * Give the current page to the popover. Every page has the same button count, so LVGL keeps its
+ * button arrays: the cost depends on the page size, not on the size of the set.
+ */
+static void t9_popover_show_page(t9_keyboard_t *kb, lv_obj_t *popover)
+{
+    t9_popover_build_page(kb);
+    lv_buttonmatrix_set_map(popover, kb->page_map);
+    T9_STAT_INC(kb, map_rebuilds);
+    for (uint32_t i = 0; i < T9_POPOVER_PAGE_CELLS; i++)
+    {
+        if (kb->page_map[i + i / T9_POPOVER_PAGE_COLS][0] == '\0')
+            lv_buttonmatrix_set_button_ctrl(popover, i, LV_BUTTONMATRIX_CTRL_HIDDEN);
+        else
+            lv_buttonmatrix_clear_button_ctrl(popover, i, LV_BUTTONMATRIX_CTRL_HIDDEN);
+    }
+}
+
+// Show the previous (dir < 0) or next page of the open paged popover, wrapping around
+static void t9_popover_flip(t9_keyboard_t *kb, int dir)
+{
+    kb->page = (uint8_t)((kb->page + kb->page_count + (dir < 0 ? -1 : 1)) % kb->page_count);
+    t9_popover_show_page(kb, kb->popover);
+}
+
+/**
+ * Insert the character of a popover button into the linked textarea and close the popover.
+ *
+ * @param btn_id Button of the open popover
+ * @param now Time of the selection in ms
+ */
+static void t9_popover_select(t9_keyboard_t *kb, uint32_t btn_id, uint32_t now)
+{
+    t9_input_record(kb, LV_KEYBOARD_T9_INPUT_POPOVER, btn_id, now);
+    T9_HANDLER_BEGIN(kb, LV_KEYBOARD_T9_TRACE_POPOVER);
+    t9_dirty_begin(kb);
+    if (kb->popover && kb->page_count && btn_id >= T9_POPOVER_PAGE_CELLS)
+    {
+        // Navigation row: previous, page number, next
+        if (btn_id == T9_POPOVER_PAGE_CELLS)
+            t9_popover_flip(kb, -1);
+        else if (btn_id == T9_POPOVER_PAGE_CELLS + 2)
+            t9_popover_flip(kb, 1);
+        T9_HANDLER_END(kb, LV_KEYBOARD_T9_TRACE_POPOVER);
+        return;
+    }
+    const char *txt = kb->popover ? lv_buttonmatrix_get_button_text(kb->popover, btn_id) : NULL;
+    if (txt && txt[0] != '\0' && kb->ta && lv_strcmp(txt, "\n") != 0)
+    {
+        t9_ta_add_text(kb, txt);
+        t9_popover_close(kb);
+    }
+    T9_HANDLER_END(kb, LV_KEYBOARD_T9_TRACE_POPOVER);
+}
+
+// Event callback for popover buttonmatrix selection
+static void t9_popover_event_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    lv_obj_t *popover = lv_event_get_target(e);
+    if (popover == kb->popover)
+        t9_popover_select(kb, lv_buttonmatrix_get_selected_button(popover), lv_tick_get());
+}
+
+// A horizontal swipe on a paged popover flips the page, like its navigation buttons
+static void t9_popover_gesture_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    if (lv_event_get_target(e) != kb->popover || kb->page_count == 0)
+        return;
+    lv_indev_t *indev = lv_indev_active();
+    lv_dir_t dir = lv_indev_get_gesture_dir(indev);
+    if (dir != LV_DIR_LEFT && dir != LV_DIR_RIGHT)
+        return;
+    lv_indev_wait_release(indev); // The swipe must not also pick the button under it
+    t9_popover_select(kb, T9_POPOVER_PAGE_CELLS + (dir == LV_DIR_LEFT ? 2 : 0), lv_tick_get());
+}
+
+// Close the open popover without inserting anything, as one keyboard operation
+static void t9_popover_dismiss(t9_keyboard_t *kb, uint32_t now)
+{
+    t9_input_record(kb, LV_KEYBOARD_T9_INPUT_POPOVER_CLOSE, 0, now);
+    T9_AUDIT_BEGIN(kb);
+    t9_dirty_begin(kb);
+    t9_popover_close(kb);
+    T9_AUDIT_END(kb, LV_KEYBOARD_T9_TRACE_POPOVER);
+}
+
+/**
+ * Get the popover map of a T9 key: the prebuilt map of the charset pack, whose button count is the
+ * char count of the key, or the page map when the set is larger (paged, the first page is set up).
+ *
+ * @param upper Upper case chars
+ * @param char_idx T9 key index (0-9)
+ * @param btn_cnt Receives the button count of the map
+ * @param paged Receives whether the popover is paged
+ * @return The map, NULL if the key has no chars
+ */
+static const char *const *t9_popover_key_map(t9_keyboard_t *kb, bool upper, uint32_t char_idx, uint16_t *btn_cnt,
+                                             bool *paged)
+{
+    const lv_keyboard_t9_charset_t *cs = kb->core.charset;
+    uint32_t case_idx = upper ? 1 : 0;
+    uint32_t key = case_idx * T9_BUTTON_COUNT + char_idx;
+    uint16_t cnt = (uint16_t)(cs->key_first[key + 1] - cs->key_first[key]);
+    const char *const *map = cs->popover_maps[case_idx][char_idx];
+    if (cnt == 0)
+        return NULL;
+    // Larger sets (no prebuilt map) are paged, all their pages have the same button count
+    *paged = cnt > T9_POPOVER_PAGE_THRESHOLD || map == NULL;
+    if (*paged)
+    {
+        kb->page_first = cs->key_first[key];
+        kb->page_chars = cnt;
+        kb->page = 0;
+        kb->page_count = (uint8_t)LV_MIN((cnt + T9_POPOVER_PAGE_CELLS - 1) / T9_POPOVER_PAGE_CELLS, UINT8_MAX);
+        map = kb->page_map;
+        cnt = T9_POPOVER_PAGE_BTNS;
+    }
+    *btn_cnt = cnt;
+    return map;
+}
+
+// Popover slot for a map of btn_cnt buttons: the one with the same count, else an empty one, else the next victim
+static uint32_t t9_popover_slot(t9_keyboard_t *kb, uint16_t btn_cnt)
+{
+    uint32_t slot = T9_POPOVER_CACHE_SIZE;
+    for (uint32_t i = 0; i < T9_POPOVER_CACHE_SIZE && slot == T9_POPOVER_CACHE_SIZE; i++)
+    {
+        if (kb->popovers[i] && kb->popover_btn_cnt[i] == btn_cnt)
+            slot = i;
+    }
+    for (uint32_t i = 0; i < T9_POPOVER_CACHE_SIZE && slot == T9_POPOVER_CACHE_SIZE; i++)
+    {
+        if (kb->popovers[i] == NULL)
+            slot = i;
+    }
+    if (slot == T9_POPOVER_CACHE_SIZE)
+    {
+        slot = kb->popover_victim;
+        kb->popover_victim = (uint8_t)((kb->popover_victim + 1) % T9_POPOVER_CACHE_SIZE);
+    }
+    return slot;
+}
+
+/**
+ * Give map to the popover of a slot and size it, the caller shows it. Only a new object or another
+ * button count than the last map of the slot allocates (lv_keyboard_t9_warm_up does it ahead).
+ *
+ * @param slot Slot of the popover cache, created if empty
+ * @param map Map of t9_popover_key_map
+ * @param btn_cnt Button count of map
+ * @param paged map is the page map
+ */
+static lv_obj_t *t9_popover_prepare(t9_keyboard_t *kb, uint32_t slot, const char *const *map, uint16_t btn_cnt,
+                                    bool paged)
+{
+    lv_obj_t *keyboard = lv_obj_get_parent(kb->btnmatrix);
+    lv_obj_t *popover = kb->popovers[slot];
+    if (popover == NULL)
+    {
+        // First use of this slot, the object is kept (hidden) for the next long-presses
+        popover = lv_buttonmatrix_create(keyboard);
+        t9_theme_add(popover, kb->theme->popover);
+        lv_obj_remove_flag(popover, LV_OBJ_FLAG_CLICK_FOCUSABLE);
+        lv_obj_add_event_cb(popover, t9_popover_event_cb, LV_EVENT_VALUE_CHANGED, kb);
+        lv_obj_add_event_cb(popover, t9_popover_gesture_cb, LV_EVENT_GESTURE, kb);
+        lv_obj_remove_flag(popover, LV_OBJ_FLAG_GESTURE_BUBBLE);
+        kb->popovers[slot] = popover;
+    }
+    if (paged)
+    {
+        bool new_btns = kb->popover_btn_cnt[slot] != btn_cnt;
+        t9_popover_show_page(kb, popover);
+        if (new_btns || !(kb->popover_paged & (1u << slot)))
+        {
+            // Pick on release, so that a swipe over a char flips the page instead of inserting it
+            lv_buttonmatrix_set_button_ctrl_all(popover, LV_BUTTONMATRIX_CTRL_NO_REPEAT | LV_BUTTONMATRIX_CTRL_CLICK_TRIG);
+            kb->popover_btn_cnt[slot] = btn_cnt;
+            kb->popover_paged |= (uint16_t)(1u << slot);
+        }
+    }
+    else if (lv_buttonmatrix_get_map(popover) != map)
+    {
+        if (kb->popover_paged & (1u << slot))
+        {
+            // Same button count as a page, drop the ctrl bits of the pages
+            lv_buttonmatrix_clear_button_ctrl_all(popover, LV_BUTTONMATRIX_CTRL_HIDDEN | LV_BUTTONMATRIX_CTRL_CLICK_TRIG);
+            kb->popover_paged &= (uint16_t)~(1u << slot);
+        }
+        // Same button count keeps the LVGL button arrays (and the ctrl bits), others reallocate them
+        lv_buttonmatrix_set_map(popover, map);
+        T9_STAT_INC(kb, map_rebuilds);
+        if (kb->popover_btn_cnt[slot] != btn_cnt)
+        {
+            //Disable "repeat" for popover buttons
+            lv_buttonmatrix_set_button_ctrl_all(popover, LV_BUTTONMATRIX_CTRL_NO_REPEAT);
+            kb->popover_btn_cnt[slot] = btn_cnt;
+        }
+    }
+    LV_LOG_INFO("Popover slot=%d buttons=%d", (int)slot, (int)btn_cnt);
+
+    // Fill most of the parent, or a third of it for up to two rows. Relative sizes are resolved by
+    // the next regular layout pass, the long-press does not force one
+    lv_obj_set_size(popover, lv_pct(90), lv_pct(btn_cnt <= 2 * 4 ? 33 : 90));
+    lv_obj_center(popover);
+    return popover;
+}
+
+/**
+ * Show a popover with given characters for selection.
+ * It is called when a long-press is detected on a T9 button (touch or keypad).
+ *
+ * @param kb Keyboard state
+ * @param btn_id Long-pressed button of the keyboard matrix
+ */
+static void t9_handle_longpress(t9_keyboard_t *kb, uint32_t btn_id)
+{
+    const t9_btn_action_t *action = t9_get_btn_action(kb, btn_id);
+    if (!action || action->action != T9_ACTION_CHAR)
+        return; // No popover (nor char to undo) for helper buttons, backspace keeps repeating
+    int char_idx = action->char_idx;
+
+    //delete previous character in tarea
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    if (kb->core.mode == T9_MODE_PREDICTIVE && char_idx >= 1 && char_idx <= 8 && kb->pred_len > 0)
+    {
+        // The press added a digit to the composed word, undo it and commit the rest
+        uint8_t prev_len = kb->pred_len;
+        t9_pred_pop(kb);
+        t9_pred_render(kb, prev_len);
+        t9_pred_reset(kb);
+    }
+    else
+#endif
+    if (kb->pending[0] != '\0')
+        t9_compose_discard(kb); // The press only made it pending
+    else if (kb->ta)
+        t9_ta_delete_chars(kb, 1);
+
+    // Disable popover in Number mode
+    if (kb->core.mode == T9_MODE_NUMBERS)
+    {
+        LV_LOG_INFO("Long-press: popover disabled in Number mode");
+        return;
+    }
+
+    uint16_t btn_cnt;
+    bool paged;
+    const char *const *map = t9_popover_key_map(kb, kb->core.mode == T9_MODE_UPPER, (uint32_t)char_idx, &btn_cnt, &paged);
+    if (map == NULL)
+        return;
+    lv_obj_t *popover = t9_popover_prepare(kb, t9_popover_slot(kb, btn_cnt), map, btn_cnt, paged);
+    lv_obj_move_foreground(popover);
+    lv_obj_remove_flag(popover, LV_OBJ_FLAG_HIDDEN);
+    kb->popover = popover;
+    T9_STAT_INC(kb, popovers);
+}
+
+// Run a long-press as one keyboard operation (dirty report, stats and trace)
+static void t9_do_longpress(t9_keyboard_t *kb, uint32_t btn_id, uint32_t now)
+{
+    t9_input_record(kb, LV_KEYBOARD_T9_INPUT_LONGPRESS, btn_id, now);
+    T9_HANDLER_BEGIN(kb, LV_KEYBOARD_T9_TRACE_LONGPRESS);
+    t9_dirty_begin(kb);
+    t9_handle_longpress(kb, btn_id);
+    T9_HANDLER_END(kb, LV_KEYBOARD_T9_TRACE_LONGPRESS);
+}
+
+// Event callback for buttonmatrix long-presses
+static void t9_btnmatrix_longpress_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    lv_obj_t *btnmatrix = lv_event_get_target(e);
+    t9_do_longpress(kb, lv_buttonmatrix_get_selected_button(btnmatrix), lv_tick_get());
+}
+
+// A touch release ends a backspace hold
+static void t9_btnmatrix_release_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    kb->bs_held = false;
+}
+
+#if LV_KEYBOARD_T9_USE_INPUT_TRACE
+/**
+ * Run a recorded input through the handler of its operation (called by lv_keyboard_t9_input_trace.c),
+ * exactly as the touch or keypad input that was recorded.
+ *
+ * @param btn_id Button of the keyboard matrix, of the open popover or of the candidate bar
+ * @param now Recorded time of the input in ms
+ */
+void t9_input_apply(t9_keyboard_t *kb, lv_keyboard_t9_input_t input, uint32_t btn_id, uint32_t now)
+{
+    switch (input)
+    {
+    case LV_KEYBOARD_T9_INPUT_PRESS:
+        t9_do_press(kb, btn_id, now);
+        break;
+    case LV_KEYBOARD_T9_INPUT_LONGPRESS:
+        t9_do_longpress(kb, btn_id, now);
+        break;
+    case LV_KEYBOARD_T9_INPUT_POPOVER:
+        if (kb->popover)
+            t9_popover_select(kb, btn_id, now);
+        break;
+    case LV_KEYBOARD_T9_INPUT_CANDIDATE:
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+        t9_pred_select(kb, btn_id, now);
+#endif
+        break;
+    case LV_KEYBOARD_T9_INPUT_POPOVER_CLOSE:
+        t9_popover_dismiss(kb, now);
+        break;
+    default:
+        break;
+    }
+}
+#endif
+
+#if LV_KEYBOARD_T9_USE_KEYPAD
+// --- Keypad input ---
+
+/*
+ * Show the held key as the selected button. The matrix is put in the focus-key state once, then
+ * lv_buttonmatrix_set_selected_button only invalidates the previous and the new key.
+ */
+static void t9_keypad_highlight(t9_keyboard_t *kb, uint32_t btn_id)
+{
+    if (!kb->key_focused)
+    {
+        lv_obj_add_state(kb->btnmatrix, LV_STATE_FOCUSED | LV_STATE_FOCUS_KEY);
+        kb->key_focused = true;
+        t9_key_cache_invalidate(kb); // The theme may style the focused matrix
+    }
+    lv_buttonmatrix_set_selected_button(kb->btnmatrix, btn_id);
+}
+
+// With a popover open, digit keys pick one of its first ten chars (of the page), '*' and '#' flip
+// the pages of a paged popover, other keys close it
+static void t9_keypad_popover_key(t9_keyboard_t *kb, lv_keyboard_t9_key_t key, uint32_t timestamp)
+{
+    if (key <= LV_KEYBOARD_T9_KEY_0)
+    {
+        uint32_t btn_id = (uint32_t)key; // '1' is the first button, '0' the tenth
+        const char *txt = lv_buttonmatrix_get_button_text(kb->popover, btn_id);
+        if (txt != NULL)
+            t9_popover_select(kb, btn_id, timestamp);
+        return;
+    }
+    if (kb->page_count && (key == LV_KEYBOARD_T9_KEY_CASE || key == LV_KEYBOARD_T9_KEY_MODE))
+    {
+        t9_popover_select(kb, T9_POPOVER_PAGE_CELLS + (key == LV_KEYBOARD_T9_KEY_MODE ? 2 : 0), timestamp);
+        return;
+    }
+    t9_popover_dismiss(kb, timestamp);
+}
+
+/**
+ * Feed a key of a physical keypad, without any hit-testing or pointer emulation.
+ * A key reported as pressed again while held is not a new press: after T9_KEYPAD_LONG_PRESS_MS
+ * it long-presses (popover, like a touch long-press) or starts the backspace repeat.
+ * Only the highlight of the pressed key is redrawn on the matrix.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param key Key
+ * @param pressed true while the key is down, false on release
+ * @param timestamp Time of the event in ms, e.g. lv_tick_get()
+ */
+void lv_keyboard_t9_feed_key(lv_obj_t *keyboard, lv_keyboard_t9_key_t key, bool pressed, uint32_t timestamp)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL || key >= LV_KEYBOARD_T9_KEY_COUNT)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_feed_key: keyboard is NULL or invalid key");
+        return;
+    }
+    // A key the layout does not have (e.g. shift) is no button: it only acts on an open popover
+    uint32_t btn_id = kb->layout->btn_ids[key] ? kb->layout->btn_ids[key] - 1u : LV_BUTTONMATRIX_BUTTON_NONE;
+
+    if (!pressed)
+    {
+        if (kb->key_down == (int8_t)key)
+        {
+            kb->key_down = -1;
+            kb->bs_held = false;
+            lv_buttonmatrix_set_selected_button(kb->btnmatrix, LV_BUTTONMATRIX_BUTTON_NONE);
+        }
+        return;
+    }
+
+    if (kb->key_down == (int8_t)key)
+    {
+        // Still held
+        uint32_t held = timestamp - kb->key_down_time;
+        if (!kb->key_long_done)
+        {
+            if (held < T9_KEYPAD_LONG_PRESS_MS)
+                return;
+            kb->key_long_done = true;
+            kb->key_repeat_time = timestamp;
+            t9_do_longpress(kb, btn_id, timestamp);
+        }
+        else if (key == LV_KEYBOARD_T9_KEY_BACKSPACE && timestamp - kb->key_repeat_time >= T9_KEYPAD_REPEAT_MS)
+        {
+            kb->key_repeat_time = timestamp;
+            t9_do_press(kb, btn_id, timestamp);
+        }
+        return;
+    }
+
+    // New press, it also releases a previously held key
+    kb->key_down = (int8_t)key;
+    kb->key_down_time = timestamp;
+    kb->key_long_done = false;
+    t9_keypad_highlight(kb, btn_id);
+    if (kb->popover)
+    {
+        kb->key_long_done = true; // The key only acts on the popover
+        t9_keypad_popover_key(kb, key, timestamp);
+        return;
+    }
+    t9_do_press(kb, btn_id, timestamp);
+}
+
+// Translate an LV_KEY_* / ASCII code to a keypad key, -1 if the keyboard has no such key
+static int t9_keypad_translate(uint32_t code)
+{
+    if (code >= '1' && code <= '9')
+        return LV_KEYBOARD_T9_KEY_1 + (int)(code - '1');
+    switch (code)
+    {
+    case '0':
+        return LV_KEYBOARD_T9_KEY_0;
+    case LV_KEY_BACKSPACE:
+        return LV_KEYBOARD_T9_KEY_BACKSPACE;
+    case LV_KEY_ENTER:
+        return LV_KEYBOARD_T9_KEY_OK;
+    case LV_KEY_ESC:
+        return LV_KEYBOARD_T9_KEY_CLOSE;
+    case ' ':
+        return LV_KEYBOARD_T9_KEY_SPACE;
+    case '*':
+        return LV_KEYBOARD_T9_KEY_CASE;
+    case '#':
+        return LV_KEYBOARD_T9_KEY_MODE;
+    default:
+        return -1;
+    }
+}
+
+static void t9_keypad_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    lv_obj_t *keyboard = lv_indev_get_user_data(indev);
+    if (keyboard == NULL)
+    {
+        data->state = LV_INDEV_STATE_RELEASED; // The keyboard is deleted, so is the device soon
+        return;
+    }
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    uint32_t code = 0;
+    bool pressed = kb->keypad_read_cb(keyboard, &code);
+    uint32_t now = lv_tick_get();
+    data->key = code;
+    data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+
+    // The callbacks of a key may still delete the keyboard (e.g. a textarea event), which clears the user data
+    int key = pressed ? t9_keypad_translate(code) : -1;
+    kb->keypad_reading = true;
+    if (kb->key_down >= 0 && kb->key_down != key)
+        lv_keyboard_t9_feed_key(keyboard, (lv_keyboard_t9_key_t)kb->key_down, false, now);
+    if (lv_indev_get_user_data(indev) == NULL)
+        return;
+    if (key >= 0)
+        lv_keyboard_t9_feed_key(keyboard, (lv_keyboard_t9_key_t)key, true, now);
+    if (lv_indev_get_user_data(indev) == NULL)
+        return;
+    kb->keypad_reading = false;
+}
+
+// Send the READY/CANCEL latched by a keypad press, outside the read callback
+static void t9_keypad_timer_cb(lv_timer_t *timer)
+{
+    t9_keyboard_t *kb = lv_timer_get_user_data(timer);
+    lv_timer_pause(timer);
+    int event = kb->keypad_event;
+    kb->keypad_event = -1;
+    // Last, kb and this timer may be deleted by the callback
+    if (event >= 0 && kb->event_cb)
+        kb->event_cb(kb->btnmatrix, (lv_keyboard_t9_event_t)event);
+}
+
+static void t9_keypad_delete_async(void *indev)
+{
+    lv_indev_delete(indev);
+}
+
+// Delete the keypad device of a deleted keyboard, later if LVGL is reading it right now
+static void t9_keypad_delete(t9_keyboard_t *kb)
+{
+    if (!kb->keypad_reading)
+    {
+        lv_indev_delete(kb->keypad);
+        return;
+    }
+    lv_indev_set_user_data(kb->keypad, NULL); // Reads released until deleted
+    if (lv_async_call(t9_keypad_delete_async, kb->keypad) != LV_RESULT_OK)
+        LV_LOG_WARN("t9_keypad_delete: out of memory, the keypad device is left idle");
+}
+
+/**
+ * Create a keypad input device for the keyboard. read_cb is polled by LVGL like any input
+ * device and its keys are fed with lv_keyboard_t9_feed_key. The device is not added to a
+ * group, so only the keyboard sees the keys. The READY/CANCEL of its OK and close keys is sent
+ * right after the read callback returns (a timer of the keypad), so the event callback may delete
+ * the keyboard. The device is deleted together with the keyboard.
+ *
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param read_cb Keypad scan callback
+ * @return The input device, or NULL on failure (one keypad per keyboard)
+ */
+lv_indev_t *lv_keyboard_t9_create_keypad(lv_obj_t *keyboard, lv_keyboard_t9_keypad_read_cb_t read_cb)
+{
+    t9_keyboard_t *kb = t9_get_keyboard(keyboard);
+    if (kb == NULL || read_cb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_create_keypad: keyboard or read_cb is NULL");
+        return NULL;
+    }
+    if (kb->keypad)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_create_keypad: the keyboard already has a keypad");
+        return NULL;
+    }
+    kb->keypad_timer = lv_timer_create(t9_keypad_timer_cb, 0, kb);
+    if (kb->keypad_timer == NULL)
+        return NULL;
+    lv_timer_pause(kb->keypad_timer);
+    lv_indev_t *indev = lv_indev_create();
+    if (indev == NULL)
+    {
+        lv_timer_delete(kb->keypad_timer);
+        kb->keypad_timer = NULL;
+        return NULL;
+    }
+    lv_indev_set_type(indev, LV_INDEV_TYPE_KEYPAD);
+    lv_indev_set_user_data(indev, keyboard);
+    lv_indev_set_read_cb(indev, t9_keypad_read_cb);
+    kb->keypad_read_cb = read_cb;
+    kb->keypad = indev;
+    return indev;
+}
+
+#endif // LV_KEYBOARD_T9_USE_KEYPAD
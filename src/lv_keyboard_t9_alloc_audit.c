@@ -0,0 +1,72 @@
+/**
+ * @file lv_keyboard_t9_alloc_audit.c
+ * @brief Allocation audit of the keyboard handlers (LV_KEYBOARD_T9_USE_ALLOC_AUDIT).
+ *
+ * The allocator of the application reports every lv_malloc / lv_realloc through
+ * lv_keyboard_t9_alloc_audit_hook. A handler notes the reported count when it starts and charges the
+ * difference to its keyboard when it returns, so a warmed keyboard can be checked to never touch the
+ * heap while handling input. Handlers run on the LVGL thread one at a time, a nested run of the same
+ * keyboard (e.g. a popover button picked from the keypad path) is part of the outer one. The nesting
+ * depth lives in the keyboard, so a keyboard deleted by a callback takes it along. The end of a run
+ * is charged before any LV_KEYBOARD_T9_EVENT_* callback is sent (t9_do_press).
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+
+static uint32_t t9_alloc_audit_cnt;   // Allocations reported by the hook
+static uint32_t t9_alloc_audit_bytes;
+
+/**
+ * @brief Report an allocation, e.g. from lv_malloc_core and lv_realloc_core of an LV_STDLIB_CUSTOM allocator.
+ * @param size Bytes requested
+ */
+void lv_keyboard_t9_alloc_audit_hook(size_t size)
+{
+    t9_alloc_audit_cnt++;
+    t9_alloc_audit_bytes += (uint32_t)size;
+}
+
+// A handler starts, return what has been reported so far
+t9_alloc_mark_t t9_alloc_audit_begin(t9_keyboard_t *kb)
+{
+    t9_alloc_mark_t mark = {t9_alloc_audit_cnt, t9_alloc_audit_bytes};
+    if (kb->alloc_depth < UINT8_MAX)
+        kb->alloc_depth++;
+    return mark;
+}
+
+// The handler started at mark returns, charge what it allocated to kb
+void t9_alloc_audit_end(t9_keyboard_t *kb, lv_keyboard_t9_trace_t id, t9_alloc_mark_t mark)
+{
+    if (kb->alloc_depth > 0)
+        kb->alloc_depth--;
+    if (kb->alloc_depth > 0)
+        return;
+    lv_keyboard_t9_alloc_audit_t *audit = &kb->alloc_audit;
+    audit->handlers++;
+    uint32_t cnt = t9_alloc_audit_cnt - mark.cnt;
+    if (cnt == 0)
+        return;
+    uint32_t bytes = t9_alloc_audit_bytes - mark.bytes;
+    audit->alloc_handlers++;
+    audit->alloc_cnt += cnt;
+    audit->alloc_bytes += bytes;
+    audit->last_trace = (uint8_t)id;
+    LV_LOG_WARN("lv_keyboard_t9: handler %d made %u allocations (%u bytes)%s", (int)id, (unsigned)cnt,
+                (unsigned)bytes, audit->warm ? " after warm-up" : "");
+#if T9_ALLOC_AUDIT_ASSERT
+    LV_ASSERT_MSG(!audit->warm, "lv_keyboard_t9: allocation in a handler of a warmed keyboard");
+#endif
+}
+
+#else
+
+void lv_keyboard_t9_alloc_audit_hook(size_t size)
+{
+    LV_UNUSED(size);
+}
+
+#endif // LV_KEYBOARD_T9_USE_ALLOC_AUDIT
@@ -0,0 +1,276 @@
+/**
+ * @file
+ * @brief Built-in charset packs, generated by tools/t9_charset_gen.py (do not edit by hand).
+ */
+#include "t9_core.h"
+
+// --- default: ASCII letters, the keyboard default ---
+
+static const char t9_cs_default_blob[] =
+    "1" "\0" ":" "\0" ";" "\0" "<" "\0" "=" "\0" ">" "\0" "?" "\0" "@" "\0"
+    "[" "\0" "\\" "\0" "]" "\0" "^" "\0" "_" "\0" "`" "\0" "{" "\0" "|" "\0"
+    "}" "\0" "~" "\0" "a" "\0" "b" "\0" "c" "\0" "2" "\0" "d" "\0" "e" "\0"
+    "f" "\0" "3" "\0" "g" "\0" "h" "\0" "i" "\0" "4" "\0" "j" "\0" "k" "\0"
+    "l" "\0" "5" "\0" "m" "\0" "n" "\0" "o" "\0" "6" "\0" "p" "\0" "q" "\0"
+    "r" "\0" "s" "\0" "7" "\0" "t" "\0" "u" "\0" "v" "\0" "8" "\0" "w" "\0"
+    "x" "\0" "y" "\0" "z" "\0" "9" "\0" "0" "\0" "!" "\0" "\"" "\0" "#" "\0"
+    "$" "\0" "%" "\0" "&" "\0" "'" "\0" "(" "\0" ")" "\0" "*" "\0" "+" "\0"
+    "," "\0" "-" "\0" "." "\0" "/" "\0" "A" "\0" "B" "\0" "C" "\0" "D" "\0"
+    "E" "\0" "F" "\0" "G" "\0" "H" "\0" "I" "\0" "J" "\0" "K" "\0" "L" "\0"
+    "M" "\0" "N" "\0" "O" "\0" "P" "\0" "Q" "\0" "R" "\0" "S" "\0" "T" "\0"
+    "U" "\0" "V" "\0" "W" "\0" "X" "\0" "Y" "\0" "Z" "\0"
+    ;
+
+static const uint16_t t9_cs_default_offs[136] = {
+    0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22,
+    24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46,
+    48, 50, 52, 54, 56, 58, 60, 62, 64, 66, 68, 70,
+    72, 74, 76, 78, 80, 82, 84, 86, 88, 90, 92, 94,
+    96, 98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118,
+    120, 122, 124, 126, 128, 130, 132, 134, 0, 2, 4, 6,
+    8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+    32, 34, 136, 138, 140, 42, 142, 144, 146, 50, 148, 150,
+    152, 58, 154, 156, 158, 66, 160, 162, 164, 74, 166, 168,
+    170, 172, 84, 174, 176, 178, 92, 180, 182, 184, 186, 102,
+    104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126,
+    128, 130, 132, 134,
+};
+
+static const char *const t9_cs_default_pop_0_0[] = {
+    t9_cs_default_blob + 0, t9_cs_default_blob + 2, t9_cs_default_blob + 4, t9_cs_default_blob + 6, "\n",
+    t9_cs_default_blob + 8, t9_cs_default_blob + 10, t9_cs_default_blob + 12, t9_cs_default_blob + 14, "\n",
+    t9_cs_default_blob + 16, t9_cs_default_blob + 18, t9_cs_default_blob + 20, t9_cs_default_blob + 22, "\n",
+    t9_cs_default_blob + 24, t9_cs_default_blob + 26, t9_cs_default_blob + 28, t9_cs_default_blob + 30, "\n",
+    t9_cs_default_blob + 32, t9_cs_default_blob + 34, NULL
+};
+static const char *const t9_cs_default_pop_0_1[] = {
+    t9_cs_default_blob + 36, t9_cs_default_blob + 38, t9_cs_default_blob + 40, t9_cs_default_blob + 42, NULL
+};
+static const char *const t9_cs_default_pop_0_2[] = {
+    t9_cs_default_blob + 44, t9_cs_default_blob + 46, t9_cs_default_blob + 48, t9_cs_default_blob + 50, NULL
+};
+static const char *const t9_cs_default_pop_0_3[] = {
+    t9_cs_default_blob + 52, t9_cs_default_blob + 54, t9_cs_default_blob + 56, t9_cs_default_blob + 58, NULL
+};
+static const char *const t9_cs_default_pop_0_4[] = {
+    t9_cs_default_blob + 60, t9_cs_default_blob + 62, t9_cs_default_blob + 64, t9_cs_default_blob + 66, NULL
+};
+static const char *const t9_cs_default_pop_0_5[] = {
+    t9_cs_default_blob + 68, t9_cs_default_blob + 70, t9_cs_default_blob + 72, t9_cs_default_blob + 74, NULL
+};
+static const char *const t9_cs_default_pop_0_6[] = {
+    t9_cs_default_blob + 76, t9_cs_default_blob + 78, t9_cs_default_blob + 80, t9_cs_default_blob + 82, "\n",
+    t9_cs_default_blob + 84, NULL
+};
+static const char *const t9_cs_default_pop_0_7[] = {
+    t9_cs_default_blob + 86, t9_cs_default_blob + 88, t9_cs_default_blob + 90, t9_cs_default_blob + 92, NULL
+};
+static const char *const t9_cs_default_pop_0_8[] = {
+    t9_cs_default_blob + 94, t9_cs_default_blob + 96, t9_cs_default_blob + 98, t9_cs_default_blob + 100, "\n",
+    t9_cs_default_blob + 102, NULL
+};
+static const char *const t9_cs_default_pop_0_9[] = {
+    t9_cs_default_blob + 104, t9_cs_default_blob + 106, t9_cs_default_blob + 108, t9_cs_default_blob + 110,
+    "\n", t9_cs_default_blob + 112, t9_cs_default_blob + 114, t9_cs_default_blob + 116,
+    t9_cs_default_blob + 118, "\n", t9_cs_default_blob + 120, t9_cs_default_blob + 122,
+    t9_cs_default_blob + 124, t9_cs_default_blob + 126, "\n", t9_cs_default_blob + 128,
+    t9_cs_default_blob + 130, t9_cs_default_blob + 132, t9_cs_default_blob + 134, NULL
+};
+static const char *const t9_cs_default_pop_1_0[] = {
+    t9_cs_default_blob + 0, t9_cs_default_blob + 2, t9_cs_default_blob + 4, t9_cs_default_blob + 6, "\n",
+    t9_cs_default_blob + 8, t9_cs_default_blob + 10, t9_cs_default_blob + 12, t9_cs_default_blob + 14, "\n",
+    t9_cs_default_blob + 16, t9_cs_default_blob + 18, t9_cs_default_blob + 20, t9_cs_default_blob + 22, "\n",
+    t9_cs_default_blob + 24, t9_cs_default_blob + 26, t9_cs_default_blob + 28, t9_cs_default_blob + 30, "\n",
+    t9_cs_default_blob + 32, t9_cs_default_blob + 34, NULL
+};
+static const char *const t9_cs_default_pop_1_1[] = {
+    t9_cs_default_blob + 136, t9_cs_default_blob + 138, t9_cs_default_blob + 140, t9_cs_default_blob + 42, NULL
+};
+static const char *const t9_cs_default_pop_1_2[] = {
+    t9_cs_default_blob + 142, t9_cs_default_blob + 144, t9_cs_default_blob + 146, t9_cs_default_blob + 50, NULL
+};
+static const char *const t9_cs_default_pop_1_3[] = {
+    t9_cs_default_blob + 148, t9_cs_default_blob + 150, t9_cs_default_blob + 152, t9_cs_default_blob + 58, NULL
+};
+static const char *const t9_cs_default_pop_1_4[] = {
+    t9_cs_default_blob + 154, t9_cs_default_blob + 156, t9_cs_default_blob + 158, t9_cs_default_blob + 66, NULL
+};
+static const char *const t9_cs_default_pop_1_5[] = {
+    t9_cs_default_blob + 160, t9_cs_default_blob + 162, t9_cs_default_blob + 164, t9_cs_default_blob + 74, NULL
+};
+static const char *const t9_cs_default_pop_1_6[] = {
+    t9_cs_default_blob + 166, t9_cs_default_blob + 168, t9_cs_default_blob + 170, t9_cs_default_blob + 172,
+    "\n", t9_cs_default_blob + 84, NULL
+};
+static const char *const t9_cs_default_pop_1_7[] = {
+    t9_cs_default_blob + 174, t9_cs_default_blob + 176, t9_cs_default_blob + 178, t9_cs_default_blob + 92, NULL
+};
+static const char *const t9_cs_default_pop_1_8[] = {
+    t9_cs_default_blob + 180, t9_cs_default_blob + 182, t9_cs_default_blob + 184, t9_cs_default_blob + 186,
+    "\n", t9_cs_default_blob + 102, NULL
+};
+static const char *const t9_cs_default_pop_1_9[] = {
+    t9_cs_default_blob + 104, t9_cs_default_blob + 106, t9_cs_default_blob + 108, t9_cs_default_blob + 110,
+    "\n", t9_cs_default_blob + 112, t9_cs_default_blob + 114, t9_cs_default_blob + 116,
+    t9_cs_default_blob + 118, "\n", t9_cs_default_blob + 120, t9_cs_default_blob + 122,
+    t9_cs_default_blob + 124, t9_cs_default_blob + 126, "\n", t9_cs_default_blob + 128,
+    t9_cs_default_blob + 130, t9_cs_default_blob + 132, t9_cs_default_blob + 134, NULL
+};
+
+const t9_charset_t lv_keyboard_t9_charset_default = {
+    .blob = t9_cs_default_blob,
+    .offs = t9_cs_default_offs,
+    .key_first = {0, 18, 22, 26, 30, 34, 38, 43, 47, 52, 68, 86, 90, 94, 98, 102, 106, 111, 115, 120, 136},
+    .labels = {
+        {"1:;...", "abc2", "def3", "ghi4", "jkl5", "mno6", "pqrs7", "tuv8", "wxyz9", "0!\"..."},
+        {"1:;...", "ABC2", "DEF3", "GHI4", "JKL5", "MNO6", "PQRS7", "TUV8", "WXYZ9", "0!\"..."},
+    },
+    .popover_maps = {
+        {t9_cs_default_pop_0_0, t9_cs_default_pop_0_1, t9_cs_default_pop_0_2, t9_cs_default_pop_0_3, t9_cs_default_pop_0_4, t9_cs_default_pop_0_5, t9_cs_default_pop_0_6, t9_cs_default_pop_0_7, t9_cs_default_pop_0_8, t9_cs_default_pop_0_9},
+        {t9_cs_default_pop_1_0, t9_cs_default_pop_1_1, t9_cs_default_pop_1_2, t9_cs_default_pop_1_3, t9_cs_default_pop_1_4, t9_cs_default_pop_1_5, t9_cs_default_pop_1_6, t9_cs_default_pop_1_7, t9_cs_default_pop_1_8, t9_cs_default_pop_1_9},
+    },
+};
+
+// --- latin: ASCII letters plus Portuguese / Spanish accented letters ---
+
+static const char t9_cs_latin_blob[] =
+    "1" "\0" ":" "\0" ";" "\0" "<" "\0" "=" "\0" ">" "\0" "?" "\0" "@" "\0"
+    "[" "\0" "\\" "\0" "]" "\0" "^" "\0" "_" "\0" "`" "\0" "{" "\0" "|" "\0"
+    "}" "\0" "~" "\0" "a" "\0" "b" "\0" "c" "\0" "\xc3\xa1" "\0" "\xc3\xa0" "\0" "\xc3\xa2" "\0"
+    "\xc3\xa3" "\0" "\xc3\xa7" "\0" "2" "\0" "d" "\0" "e" "\0" "f" "\0" "\xc3\xa9" "\0" "\xc3\xaa" "\0"
+    "3" "\0" "g" "\0" "h" "\0" "i" "\0" "\xc3\xad" "\0" "4" "\0" "j" "\0" "k" "\0"
+    "l" "\0" "5" "\0" "m" "\0" "n" "\0" "o" "\0" "\xc3\xb1" "\0" "\xc3\xb3" "\0" "\xc3\xb4" "\0"
+    "\xc3\xb5" "\0" "6" "\0" "p" "\0" "q" "\0" "r" "\0" "s" "\0" "7" "\0" "t" "\0"
+    "u" "\0" "v" "\0" "\xc3\xba" "\0" "\xc3\xbc" "\0" "8" "\0" "w" "\0" "x" "\0" "y" "\0"
+    "z" "\0" "9" "\0" "0" "\0" "!" "\0" "\"" "\0" "#" "\0" "$" "\0" "%" "\0"
+    "&" "\0" "'" "\0" "(" "\0" ")" "\0" "*" "\0" "+" "\0" "," "\0" "-" "\0"
+    "." "\0" "/" "\0" "A" "\0" "B" "\0" "C" "\0" "\xc3\x81" "\0" "\xc3\x80" "\0" "\xc3\x82" "\0"
+    "\xc3\x83" "\0" "\xc3\x87" "\0" "D" "\0" "E" "\0" "F" "\0" "\xc3\x89" "\0" "\xc3\x8a" "\0" "G" "\0"
+    "H" "\0" "I" "\0" "\xc3\x8d" "\0" "J" "\0" "K" "\0" "L" "\0" "M" "\0" "N" "\0"
+    "O" "\0" "\xc3\x91" "\0" "\xc3\x93" "\0" "\xc3\x94" "\0" "\xc3\x95" "\0" "P" "\0" "Q" "\0" "R" "\0"
+    "S" "\0" "T" "\0" "U" "\0" "V" "\0" "\xc3\x9a" "\0" "\xc3\x9c" "\0" "W" "\0" "X" "\0"
+    "Y" "\0" "Z" "\0"
+    ;
+
+static const uint16_t t9_cs_latin_offs[164] = {
+    0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22,
+    24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 45, 48,
+    51, 54, 57, 59, 61, 63, 65, 68, 71, 73, 75, 77,
+    79, 82, 84, 86, 88, 90, 92, 94, 96, 98, 101, 104,
+    107, 110, 112, 114, 116, 118, 120, 122, 124, 126, 128, 131,
+    134, 136, 138, 140, 142, 144, 146, 148, 150, 152, 154, 156,
+    158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 0, 2,
+    4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26,
+    28, 30, 32, 34, 178, 180, 182, 184, 187, 190, 193, 196,
+    57, 199, 201, 203, 205, 208, 71, 211, 213, 215, 217, 82,
+    220, 222, 224, 90, 226, 228, 230, 232, 235, 238, 241, 110,
+    244, 246, 248, 250, 120, 252, 254, 256, 258, 261, 134, 264,
+    266, 268, 270, 144, 146, 148, 150, 152, 154, 156, 158, 160,
+    162, 164, 166, 168, 170, 172, 174, 176,
+};
+
+static const char *const t9_cs_latin_pop_0_0[] = {
+    t9_cs_latin_blob + 0, t9_cs_latin_blob + 2, t9_cs_latin_blob + 4, t9_cs_latin_blob + 6, "\n",
+    t9_cs_latin_blob + 8, t9_cs_latin_blob + 10, t9_cs_latin_blob + 12, t9_cs_latin_blob + 14, "\n",
+    t9_cs_latin_blob + 16, t9_cs_latin_blob + 18, t9_cs_latin_blob + 20, t9_cs_latin_blob + 22, "\n",
+    t9_cs_latin_blob + 24, t9_cs_latin_blob + 26, t9_cs_latin_blob + 28, t9_cs_latin_blob + 30, "\n",
+    t9_cs_latin_blob + 32, t9_cs_latin_blob + 34, NULL
+};
+static const char *const t9_cs_latin_pop_0_1[] = {
+    t9_cs_latin_blob + 36, t9_cs_latin_blob + 38, t9_cs_latin_blob + 40, t9_cs_latin_blob + 42, "\n",
+    t9_cs_latin_blob + 45, t9_cs_latin_blob + 48, t9_cs_latin_blob + 51, t9_cs_latin_blob + 54, "\n",
+    t9_cs_latin_blob + 57, NULL
+};
+static const char *const t9_cs_latin_pop_0_2[] = {
+    t9_cs_latin_blob + 59, t9_cs_latin_blob + 61, t9_cs_latin_blob + 63, t9_cs_latin_blob + 65, "\n",
+    t9_cs_latin_blob + 68, t9_cs_latin_blob + 71, NULL
+};
+static const char *const t9_cs_latin_pop_0_3[] = {
+    t9_cs_latin_blob + 73, t9_cs_latin_blob + 75, t9_cs_latin_blob + 77, t9_cs_latin_blob + 79, "\n",
+    t9_cs_latin_blob + 82, NULL
+};
+static const char *const t9_cs_latin_pop_0_4[] = {
+    t9_cs_latin_blob + 84, t9_cs_latin_blob + 86, t9_cs_latin_blob + 88, t9_cs_latin_blob + 90, NULL
+};
+static const char *const t9_cs_latin_pop_0_5[] = {
+    t9_cs_latin_blob + 92, t9_cs_latin_blob + 94, t9_cs_latin_blob + 96, t9_cs_latin_blob + 98, "\n",
+    t9_cs_latin_blob + 101, t9_cs_latin_blob + 104, t9_cs_latin_blob + 107, t9_cs_latin_blob + 110, NULL
+};
+static const char *const t9_cs_latin_pop_0_6[] = {
+    t9_cs_latin_blob + 112, t9_cs_latin_blob + 114, t9_cs_latin_blob + 116, t9_cs_latin_blob + 118, "\n",
+    t9_cs_latin_blob + 120, NULL
+};
+static const char *const t9_cs_latin_pop_0_7[] = {
+    t9_cs_latin_blob + 122, t9_cs_latin_blob + 124, t9_cs_latin_blob + 126, t9_cs_latin_blob + 128, "\n",
+    t9_cs_latin_blob + 131, t9_cs_latin_blob + 134, NULL
+};
+static const char *const t9_cs_latin_pop_0_8[] = {
+    t9_cs_latin_blob + 136, t9_cs_latin_blob + 138, t9_cs_latin_blob + 140, t9_cs_latin_blob + 142, "\n",
+    t9_cs_latin_blob + 144, NULL
+};
+static const char *const t9_cs_latin_pop_0_9[] = {
+    t9_cs_latin_blob + 146, t9_cs_latin_blob + 148, t9_cs_latin_blob + 150, t9_cs_latin_blob + 152, "\n",
+    t9_cs_latin_blob + 154, t9_cs_latin_blob + 156, t9_cs_latin_blob + 158, t9_cs_latin_blob + 160, "\n",
+    t9_cs_latin_blob + 162, t9_cs_latin_blob + 164, t9_cs_latin_blob + 166, t9_cs_latin_blob + 168, "\n",
+    t9_cs_latin_blob + 170, t9_cs_latin_blob + 172, t9_cs_latin_blob + 174, t9_cs_latin_blob + 176, NULL
+};
+static const char *const t9_cs_latin_pop_1_0[] = {
+    t9_cs_latin_blob + 0, t9_cs_latin_blob + 2, t9_cs_latin_blob + 4, t9_cs_latin_blob + 6, "\n",
+    t9_cs_latin_blob + 8, t9_cs_latin_blob + 10, t9_cs_latin_blob + 12, t9_cs_latin_blob + 14, "\n",
+    t9_cs_latin_blob + 16, t9_cs_latin_blob + 18, t9_cs_latin_blob + 20, t9_cs_latin_blob + 22, "\n",
+    t9_cs_latin_blob + 24, t9_cs_latin_blob + 26, t9_cs_latin_blob + 28, t9_cs_latin_blob + 30, "\n",
+    t9_cs_latin_blob + 32, t9_cs_latin_blob + 34, NULL
+};
+static const char *const t9_cs_latin_pop_1_1[] = {
+    t9_cs_latin_blob + 178, t9_cs_latin_blob + 180, t9_cs_latin_blob + 182, t9_cs_latin_blob + 184, "\n",
+    t9_cs_latin_blob + 187, t9_cs_latin_blob + 190, t9_cs_latin_blob + 193, t9_cs_latin_blob + 196, "\n",
+    t9_cs_latin_blob + 57, NULL
+};
+static const char *const t9_cs_latin_pop_1_2[] = {
+    t9_cs_latin_blob + 199, t9_cs_latin_blob + 201, t9_cs_latin_blob + 203, t9_cs_latin_blob + 205, "\n",
+    t9_cs_latin_blob + 208, t9_cs_latin_blob + 71, NULL
+};
+static const char *const t9_cs_latin_pop_1_3[] = {
+    t9_cs_latin_blob + 211, t9_cs_latin_blob + 213, t9_cs_latin_blob + 215, t9_cs_latin_blob + 217, "\n",
+    t9_cs_latin_blob + 82, NULL
+};
+static const char *const t9_cs_latin_pop_1_4[] = {
+    t9_cs_latin_blob + 220, t9_cs_latin_blob + 222, t9_cs_latin_blob + 224, t9_cs_latin_blob + 90, NULL
+};
+static const char *const t9_cs_latin_pop_1_5[] = {
+    t9_cs_latin_blob + 226, t9_cs_latin_blob + 228, t9_cs_latin_blob + 230, t9_cs_latin_blob + 232, "\n",
+    t9_cs_latin_blob + 235, t9_cs_latin_blob + 238, t9_cs_latin_blob + 241, t9_cs_latin_blob + 110, NULL
+};
+static const char *const t9_cs_latin_pop_1_6[] = {
+    t9_cs_latin_blob + 244, t9_cs_latin_blob + 246, t9_cs_latin_blob + 248, t9_cs_latin_blob + 250, "\n",
+    t9_cs_latin_blob + 120, NULL
+};
+static const char *const t9_cs_latin_pop_1_7[] = {
+    t9_cs_latin_blob + 252, t9_cs_latin_blob + 254, t9_cs_latin_blob + 256, t9_cs_latin_blob + 258, "\n",
+    t9_cs_latin_blob + 261, t9_cs_latin_blob + 134, NULL
+};
+static const char *const t9_cs_latin_pop_1_8[] = {
+    t9_cs_latin_blob + 264, t9_cs_latin_blob + 266, t9_cs_latin_blob + 268, t9_cs_latin_blob + 270, "\n",
+    t9_cs_latin_blob + 144, NULL
+};
+static const char *const t9_cs_latin_pop_1_9[] = {
+    t9_cs_latin_blob + 146, t9_cs_latin_blob + 148, t9_cs_latin_blob + 150, t9_cs_latin_blob + 152, "\n",
+    t9_cs_latin_blob + 154, t9_cs_latin_blob + 156, t9_cs_latin_blob + 158, t9_cs_latin_blob + 160, "\n",
+    t9_cs_latin_blob + 162, t9_cs_latin_blob + 164, t9_cs_latin_blob + 166, t9_cs_latin_blob + 168, "\n",
+    t9_cs_latin_blob + 170, t9_cs_latin_blob + 172, t9_cs_latin_blob + 174, t9_cs_latin_blob + 176, NULL
+};
+
+const t9_charset_t lv_keyboard_t9_charset_latin = {
+    .blob = t9_cs_latin_blob,
+    .offs = t9_cs_latin_offs,
+    .key_first = {0, 18, 27, 33, 38, 42, 50, 55, 61, 66, 82, 100, 109, 115, 120, 124, 132, 137, 143, 148, 164},
+    .labels = {
+        {"1:;...", "abc2", "def3", "ghi4", "jkl5", "mno6", "pqrs7", "tuv8", "wxyz9", "0!\"..."},
+        {"1:;...", "ABC2", "DEF3", "GHI4", "JKL5", "MNO6", "PQRS7", "TUV8", "WXYZ9", "0!\"..."},
+    },
+    .popover_maps = {
+        {t9_cs_latin_pop_0_0, t9_cs_latin_pop_0_1, t9_cs_latin_pop_0_2, t9_cs_latin_pop_0_3, t9_cs_latin_pop_0_4, t9_cs_latin_pop_0_5, t9_cs_latin_pop_0_6, t9_cs_latin_pop_0_7, t9_cs_latin_pop_0_8, t9_cs_latin_pop_0_9},
+        {t9_cs_latin_pop_1_0, t9_cs_latin_pop_1_1, t9_cs_latin_pop_1_2, t9_cs_latin_pop_1_3, t9_cs_latin_pop_1_4, t9_cs_latin_pop_1_5, t9_cs_latin_pop_1_6, t9_cs_latin_pop_1_7, t9_cs_latin_pop_1_8, t9_cs_latin_pop_1_9},
+    },
+};
+
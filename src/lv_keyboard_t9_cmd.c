@@ -0,0 +1,337 @@
+/**
+ * @file lv_keyboard_t9_cmd.c
+ * @brief Command queue of the T9 keyboard for other tasks than LVGL's (LV_KEYBOARD_T9_USE_CMD_QUEUE).
+ *
+ * lv_keyboard_t9_post_* only write a slot of a lock-free multi-producer / single-consumer ring, they
+ * never touch an LVGL object nor wait for the LVGL task. An lv_timer drains the ring on the LVGL task
+ * every T9_CMD_PERIOD_MS and runs the matching keyboard calls, coalesced per keyboard:
+ *  - set_mode: only the last mode of a drain is applied, after the other commands (one map update)
+ *  - set_textarea: only the last one is applied, before the next text of the keyboard if any
+ *  - insert_text: consecutive texts are joined and inserted with one lv_keyboard_t9_insert_text
+ *
+ * The ring is a bounded queue with a sequence number per slot: a slot is free for the position p
+ * while its sequence is p, and published once it is p + 1. Producers claim positions with a CAS on
+ * the head, a text longer than a slot claims consecutive slots at once so it is never interleaved
+ * with the commands of another task. The drain releases a slot with p + T9_CMD_QUEUE_DEPTH.
+ *
+ * Commands address the keyboard object, it is looked up among the live keyboards when drained, so the
+ * commands of a deleted keyboard are dropped. A keyboard also ignores the positions claimed before it
+ * was created: a new keyboard at the address of a deleted one does not run the commands of the old one,
+ * published or still being written.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_CMD_QUEUE
+
+#include <stdatomic.h>
+
+#if (T9_CMD_QUEUE_DEPTH & (T9_CMD_QUEUE_DEPTH - 1)) != 0
+#error "T9_CMD_QUEUE_DEPTH must be a power of 2"
+#endif
+
+typedef enum
+{
+    T9_CMD_SET_MODE,
+    T9_CMD_SET_TEXTAREA,
+    T9_CMD_INSERT_TEXT, // One chunk, whole UTF-8 chars
+} t9_cmd_type_t;
+
+typedef struct
+{
+    atomic_uint seq;
+    lv_obj_t *keyboard; // Compared with the live keyboards only
+    uint8_t type;       // t9_cmd_type_t
+    uint8_t len;        // Bytes of text
+    union
+    {
+        uint8_t mode;
+        lv_obj_t *ta;
+        char text[T9_CMD_TEXT_MAX];
+    } arg;
+} t9_cmd_t;
+
+static t9_cmd_t t9_cmd_ring[T9_CMD_QUEUE_DEPTH];
+static atomic_uint t9_cmd_head; // Next position to claim, producers
+static bool t9_cmd_ring_inited; // Written before the first keyboard exists, so before any post
+
+// LVGL task only
+static unsigned t9_cmd_tail;
+static t9_keyboard_t *t9_cmd_clients; // Keyboards the commands can address
+static lv_timer_t *t9_cmd_timer;
+
+// Texts of the keyboard being drained, joined into one insert. A drain reads at most one ring of slots.
+static lv_obj_t *t9_cmd_text_keyboard;
+static uint32_t t9_cmd_text_len;
+static char t9_cmd_text[T9_CMD_QUEUE_DEPTH * T9_CMD_TEXT_MAX];
+
+// --- Producers, any task ---
+
+// Claim n consecutive positions, false if the ring has less free slots
+static bool t9_cmd_claim(uint32_t n, unsigned *pos)
+{
+    unsigned p = atomic_load_explicit(&t9_cmd_head, memory_order_relaxed);
+    for (;;)
+    {
+        // Slots are released in order, so the last one being free means all of them are
+        unsigned last = p + n - 1;
+        unsigned seq = atomic_load_explicit(&t9_cmd_ring[last % T9_CMD_QUEUE_DEPTH].seq, memory_order_acquire);
+        int diff = (int)(seq - last);
+        if (diff < 0)
+            return false;
+        if (diff > 0)
+            p = atomic_load_explicit(&t9_cmd_head, memory_order_relaxed); // Claimed by another task meanwhile
+        else if (atomic_compare_exchange_weak_explicit(&t9_cmd_head, &p, p + n, memory_order_relaxed,
+                                                       memory_order_relaxed))
+        {
+            *pos = p;
+            return true;
+        }
+    }
+}
+
+static t9_cmd_t *t9_cmd_slot(unsigned pos, lv_obj_t *keyboard, t9_cmd_type_t type)
+{
+    t9_cmd_t *cmd = &t9_cmd_ring[pos % T9_CMD_QUEUE_DEPTH];
+    cmd->keyboard = keyboard;
+    cmd->type = (uint8_t)type;
+    return cmd;
+}
+
+static void t9_cmd_publish(t9_cmd_t *cmd, unsigned pos)
+{
+    atomic_store_explicit(&cmd->seq, pos + 1, memory_order_release);
+}
+
+// The posting functions make no LVGL call, not even a log: a NULL keyboard or a full queue only returns false
+
+/**
+ * @brief Post lv_keyboard_t9_set_mode from any task.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param mode T9 mode to set
+ * @return false if keyboard is NULL, mode is invalid or the queue is full
+ */
+bool lv_keyboard_t9_post_set_mode(lv_obj_t *keyboard, t9_mode_t mode)
+{
+    unsigned pos;
+    if (keyboard == NULL || (uint32_t)mode > T9_MODE_PREDICTIVE || !t9_cmd_claim(1, &pos))
+        return false;
+    t9_cmd_t *cmd = t9_cmd_slot(pos, keyboard, T9_CMD_SET_MODE);
+    cmd->arg.mode = (uint8_t)mode;
+    t9_cmd_publish(cmd, pos);
+    return true;
+}
+
+/**
+ * @brief Post lv_keyboard_t9_set_textarea from any task.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param ta Textarea to link, it must still exist when the queue is drained
+ * @return false if keyboard or ta is NULL or the queue is full
+ */
+bool lv_keyboard_t9_post_set_textarea(lv_obj_t *keyboard, lv_obj_t *ta)
+{
+    unsigned pos;
+    if (keyboard == NULL || ta == NULL || !t9_cmd_claim(1, &pos))
+        return false;
+    t9_cmd_t *cmd = t9_cmd_slot(pos, keyboard, T9_CMD_SET_TEXTAREA);
+    cmd->arg.ta = ta;
+    t9_cmd_publish(cmd, pos);
+    return true;
+}
+
+// Bytes of the next chunk of text, cut before a UTF-8 continuation byte
+static uint32_t t9_cmd_chunk(const char *utf8, size_t len)
+{
+    if (len <= T9_CMD_TEXT_MAX)
+        return (uint32_t)len;
+    uint32_t n = T9_CMD_TEXT_MAX;
+    while (n > 1 && ((uint8_t)utf8[n] & 0xC0) == 0x80)
+        n--;
+    return n;
+}
+
+/**
+ * @brief Post lv_keyboard_t9_insert_text from any task, the text is copied.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param utf8 Text to insert, does not need to be NUL terminated
+ * @param len Bytes of utf8, at most T9_CMD_QUEUE_DEPTH slots of T9_CMD_TEXT_MAX bytes
+ * @return false if keyboard or utf8 is NULL, the text is too long or the queue is full (nothing posted)
+ */
+bool lv_keyboard_t9_post_insert_text(lv_obj_t *keyboard, const char *utf8, size_t len)
+{
+    if (keyboard == NULL || utf8 == NULL)
+        return false;
+    if (len == 0)
+        return true;
+
+    uint32_t n = 0;
+    for (size_t off = 0; off < len; n++)
+    {
+        if (n == T9_CMD_QUEUE_DEPTH)
+            return false;
+        off += t9_cmd_chunk(utf8 + off, len - off);
+    }
+    unsigned pos;
+    if (!t9_cmd_claim(n, &pos))
+        return false;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t chunk = t9_cmd_chunk(utf8, len);
+        t9_cmd_t *cmd = t9_cmd_slot(pos + i, keyboard, T9_CMD_INSERT_TEXT);
+        lv_memcpy(cmd->arg.text, utf8, chunk);
+        cmd->len = (uint8_t)chunk;
+        t9_cmd_publish(cmd, pos + i);
+        utf8 += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+// --- Drain, LVGL task ---
+
+static t9_keyboard_t *t9_cmd_find(const lv_obj_t *keyboard)
+{
+    t9_keyboard_t *kb = t9_cmd_clients;
+    while (kb != NULL && kb->btnmatrix != keyboard)
+        kb = kb->cmd_next;
+    return kb;
+}
+
+// Insert the joined texts. The keyboard is looked up again: the callbacks of an earlier call may have deleted it.
+static void t9_cmd_text_flush(void)
+{
+    if (t9_cmd_text_len == 0)
+        return;
+    if (t9_cmd_find(t9_cmd_text_keyboard) != NULL)
+        lv_keyboard_t9_insert_text(t9_cmd_text_keyboard, t9_cmd_text, t9_cmd_text_len);
+    t9_cmd_text_len = 0;
+}
+
+static void t9_cmd_run(const t9_cmd_t *cmd, unsigned pos)
+{
+    t9_keyboard_t *kb = t9_cmd_find(cmd->keyboard);
+    if (kb == NULL || (int)(pos - kb->cmd_since) < 0)
+        return; // Deleted, or posted to a deleted keyboard at the same address
+
+    switch (cmd->type)
+    {
+    case T9_CMD_SET_MODE:
+        kb->cmd_mode = (int8_t)cmd->arg.mode;
+        break;
+    case T9_CMD_SET_TEXTAREA:
+        if (t9_cmd_text_keyboard == cmd->keyboard)
+            t9_cmd_text_flush(); // Texts posted before go to the previous textarea
+        kb->cmd_ta = cmd->arg.ta;
+        break;
+    case T9_CMD_INSERT_TEXT:
+        if (t9_cmd_text_keyboard != cmd->keyboard)
+        {
+            t9_cmd_text_flush();
+            t9_cmd_text_keyboard = cmd->keyboard;
+        }
+        if (kb->cmd_ta)
+        {
+            lv_obj_t *ta = kb->cmd_ta;
+            kb->cmd_ta = NULL;
+            lv_keyboard_t9_set_textarea(cmd->keyboard, ta);
+        }
+        lv_memcpy(t9_cmd_text + t9_cmd_text_len, cmd->arg.text, cmd->len);
+        t9_cmd_text_len += cmd->len;
+        break;
+    default:
+        break;
+    }
+}
+
+// Apply the last textarea and mode of one keyboard, false once none is left. The list is searched
+// again after every call as the callbacks may delete keyboards.
+static bool t9_cmd_apply_one(void)
+{
+    for (t9_keyboard_t *kb = t9_cmd_clients; kb != NULL; kb = kb->cmd_next)
+    {
+        if (kb->cmd_ta)
+        {
+            lv_obj_t *ta = kb->cmd_ta;
+            kb->cmd_ta = NULL;
+            lv_keyboard_t9_set_textarea(kb->btnmatrix, ta);
+            return true;
+        }
+        if (kb->cmd_mode >= 0)
+        {
+            t9_mode_t mode = (t9_mode_t)kb->cmd_mode;
+            kb->cmd_mode = -1;
+            lv_keyboard_t9_set_mode(kb->btnmatrix, mode);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void t9_cmd_timer_cb(lv_timer_t *timer)
+{
+    LV_UNUSED(timer);
+    // One ring at most, commands posted by the callbacks wait for the next period
+    for (uint32_t i = 0; i < T9_CMD_QUEUE_DEPTH; i++)
+    {
+        t9_cmd_t *cmd = &t9_cmd_ring[t9_cmd_tail % T9_CMD_QUEUE_DEPTH];
+        if (atomic_load_explicit(&cmd->seq, memory_order_acquire) != t9_cmd_tail + 1)
+            break; // Empty, or the next slot is still being written
+        t9_cmd_run(cmd, t9_cmd_tail);
+        atomic_store_explicit(&cmd->seq, t9_cmd_tail + T9_CMD_QUEUE_DEPTH, memory_order_release);
+        t9_cmd_tail++;
+    }
+    // Keep the creation positions close to the tail, so the comparison never wraps
+    for (t9_keyboard_t *kb = t9_cmd_clients; kb != NULL; kb = kb->cmd_next)
+    {
+        if ((int)(t9_cmd_tail - kb->cmd_since) > 0)
+            kb->cmd_since = t9_cmd_tail;
+    }
+    t9_cmd_text_flush();
+    t9_cmd_text_keyboard = NULL;
+    while (t9_cmd_apply_one())
+    {
+    }
+}
+
+// Register a new keyboard, the drain timer runs while one exists
+void t9_cmd_attach(t9_keyboard_t *kb)
+{
+    if (!t9_cmd_ring_inited)
+    {
+        for (unsigned i = 0; i < T9_CMD_QUEUE_DEPTH; i++)
+            atomic_init(&t9_cmd_ring[i].seq, i);
+        t9_cmd_ring_inited = true;
+    }
+    kb->cmd_mode = -1;
+    // Positions claimed so far are older commands, a producer can only address this keyboard once it is returned
+    kb->cmd_since = atomic_load_explicit(&t9_cmd_head, memory_order_acquire);
+    kb->cmd_next = t9_cmd_clients;
+    t9_cmd_clients = kb;
+    if (t9_cmd_timer == NULL)
+    {
+        t9_cmd_timer = lv_timer_create(t9_cmd_timer_cb, T9_CMD_PERIOD_MS, NULL);
+        if (t9_cmd_timer == NULL)
+            LV_LOG_WARN("t9_cmd_attach: could not create the drain timer");
+    }
+}
+
+// Unregister a deleted keyboard, its queued commands find no keyboard or one created after them
+void t9_cmd_detach(t9_keyboard_t *kb)
+{
+    t9_keyboard_t **link = &t9_cmd_clients;
+    while (*link != NULL && *link != kb)
+        link = &(*link)->cmd_next;
+    if (*link != NULL)
+        *link = kb->cmd_next;
+    if (t9_cmd_text_keyboard == kb->btnmatrix)
+        t9_cmd_text_len = 0;
+
+    if (t9_cmd_clients == NULL && t9_cmd_timer != NULL)
+    {
+        lv_timer_delete(t9_cmd_timer);
+        t9_cmd_timer = NULL;
+    }
+}
+
+#endif // LV_KEYBOARD_T9_USE_CMD_QUEUE
@@ -0,0 +1,313 @@
+/**
+ * @file lv_keyboard_t9_dict.c
+ * @brief Dictionary digit trie used by the T9 keyboard predictive mode.
+ *
+ * Words are inserted by their keypad digit sequence, so walking the trie one
+ * node per keypress costs at most 8 sibling visits, independent of the
+ * dictionary size. Every node keeps its exact matches as a list sorted by rank
+ * and the best word of its whole subtree, to show a prefix while typing.
+ *
+ * The trie is either built in RAM from a word list (lv_keyboard_t9_dict_create)
+ * or read in place from a packed image of the same trie (lv_keyboard_t9_dict_open,
+ * format in lv_keyboard_t9_private.h), e.g. in memory-mapped flash. A packed
+ * dictionary only costs its handle in RAM, opening it checks the header and
+ * the lookups bound every index they read.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+
+// Keypad digit for each letter 'a'..'z'
+static const uint8_t t9_letter_digit[26] = {
+    2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7, 7, 8, 8, 8, 9, 9, 9, 9};
+
+// Set bits of a nibble, for the child index in a packed node
+static const uint8_t t9_nibble_bits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/**
+ * Get the keypad digit of a letter, case insensitive.
+ *
+ * @return 2..9, or -1 if c is not an ASCII letter
+ */
+int t9_dict_letter_digit(char c)
+{
+    if (c >= 'A' && c <= 'Z')
+        c = (char)(c - 'A' + 'a');
+    if (c < 'a' || c > 'z')
+        return -1;
+    return t9_letter_digit[c - 'a'];
+}
+
+static uint32_t t9_dict_add_node(t9_dict_t *dict, uint32_t *capacity, uint32_t parent, uint8_t digit)
+{
+    if (dict->node_count == *capacity)
+    {
+        uint32_t new_capacity = *capacity * 2;
+        t9_dict_node_t *nodes = lv_realloc(dict->nodes, new_capacity * sizeof(t9_dict_node_t));
+        if (nodes == NULL)
+            return T9_DICT_NONE;
+        dict->nodes = nodes;
+        *capacity = new_capacity;
+    }
+    uint32_t idx = dict->node_count++;
+    t9_dict_node_t *node = &dict->nodes[idx];
+    lv_memzero(node, sizeof(*node));
+    node->digit = digit;
+    node->next_sibling = dict->nodes[parent].first_child;
+    dict->nodes[parent].first_child = idx;
+    return idx;
+}
+
+/**
+ * Create a dictionary from a list of words.
+ *
+ * @param words Array of ASCII words, referenced (not copied), must outlive the dictionary
+ * @param freqs Optional per word frequency, if NULL the list order is used (first is most frequent)
+ * @param count Number of words
+ * @return The dictionary, or NULL on allocation failure
+ */
+t9_dict_t *lv_keyboard_t9_dict_create(const char *const *words, const uint16_t *freqs, uint32_t count)
+{
+    if (words == NULL || count == 0)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_create: empty word list");
+        return NULL;
+    }
+
+    t9_dict_t *dict = lv_malloc_zeroed(sizeof(t9_dict_t));
+    if (dict == NULL)
+        return NULL;
+
+    uint32_t capacity = count + 1;
+    dict->nodes = lv_malloc(capacity * sizeof(t9_dict_node_t));
+    dict->rank = lv_malloc(count * sizeof(uint16_t));
+    dict->word_next = lv_malloc_zeroed(count * sizeof(uint32_t));
+    if (dict->nodes == NULL || dict->rank == NULL || dict->word_next == NULL)
+    {
+        lv_keyboard_t9_dict_delete(dict);
+        return NULL;
+    }
+    lv_memzero(&dict->nodes[T9_DICT_ROOT], sizeof(t9_dict_node_t));
+    dict->node_count = 1;
+    dict->words = words;
+    dict->word_count = count;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const char *word = words[i];
+        uint16_t rank = freqs ? freqs[i] : (uint16_t)(count - i > UINT16_MAX ? UINT16_MAX : count - i);
+        dict->rank[i] = rank;
+        if (word == NULL || word[0] == '\0')
+            continue;
+
+        // Skip words that can not be typed with the keypad letters
+        bool valid = true;
+        for (const char *c = word; *c != '\0'; c++)
+        {
+            if (t9_dict_letter_digit(*c) < 0)
+            {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid)
+        {
+            LV_LOG_INFO("lv_keyboard_t9_dict_create: skipping '%s'", word);
+            continue;
+        }
+
+        uint32_t node = T9_DICT_ROOT;
+        for (const char *c = word; *c != '\0'; c++)
+        {
+            uint8_t digit = (uint8_t)t9_dict_letter_digit(*c);
+            uint32_t child = t9_dict_child(dict, node, digit);
+            if (child == T9_DICT_NONE)
+            {
+                child = t9_dict_add_node(dict, &capacity, node, digit);
+                if (child == T9_DICT_NONE)
+                {
+                    lv_keyboard_t9_dict_delete(dict);
+                    return NULL;
+                }
+            }
+            node = child;
+            // Keep the best ranked word of the subtree for prefix display
+            t9_dict_node_t *n = &dict->nodes[node];
+            if (n->best_word == 0 || dict->rank[n->best_word - 1] < rank)
+                n->best_word = i + 1;
+        }
+
+        // Insert into the exact match list, sorted by rank (stable for equal ranks)
+        uint32_t *link = &dict->nodes[node].first_word;
+        while (*link != 0 && dict->rank[*link - 1] >= rank)
+            link = &dict->word_next[*link - 1];
+        dict->word_next[i] = *link;
+        *link = i + 1;
+    }
+
+    // Give back the unused part of the node array
+    t9_dict_node_t *nodes = lv_realloc(dict->nodes, dict->node_count * sizeof(t9_dict_node_t));
+    if (nodes != NULL)
+        dict->nodes = nodes;
+
+    LV_LOG_INFO("lv_keyboard_t9_dict_create: %d words, %d nodes", (int)count, (int)dict->node_count);
+    return dict;
+}
+
+static uint32_t t9_dict_read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// A section of count entries of entry_size bytes at off fits in size, offsets 4-byte aligned
+static bool t9_dict_section_ok(uint32_t off, uint32_t count, uint32_t entry_size, uint32_t size)
+{
+    return off % 4 == 0 && off >= T9_DICT_PACKED_HEADER_SIZE && off <= size &&
+           (uint64_t)count * entry_size <= size - off;
+}
+
+/**
+ * Open a packed dictionary in place, e.g. generated by tools/t9_dict_gen.py and linked into flash.
+ * Nothing is parsed nor copied, only the header is checked: the time and RAM do not depend on the
+ * dictionary size.
+ *
+ * @param data Packed dictionary, 4-byte aligned, must outlive the dictionary
+ * @param size Bytes readable at data, at least the size recorded in the header
+ * @return The dictionary, or NULL if data is not a packed dictionary or on allocation failure
+ */
+t9_dict_t *lv_keyboard_t9_dict_open(const void *data, uint32_t size)
+{
+    const uint8_t *p = data;
+    if (p == NULL || size < T9_DICT_PACKED_HEADER_SIZE || ((uintptr_t)p % 4) != 0)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open: data is NULL, too small or not aligned");
+        return NULL;
+    }
+    uint32_t node_count = t9_dict_read_u32(p + 4);
+    uint32_t word_count = t9_dict_read_u32(p + 8);
+    uint32_t string_size = t9_dict_read_u32(p + 12);
+    uint32_t nodes_off = t9_dict_read_u32(p + 16);
+    uint32_t words_off = t9_dict_read_u32(p + 20);
+    uint32_t strings_off = t9_dict_read_u32(p + 24);
+    uint32_t total = t9_dict_read_u32(p + 28);
+    if (p[0] != 'T' || p[1] != '9' || p[2] != 'D' || p[3] != T9_DICT_PACKED_VERSION || total > size ||
+        node_count == 0 || node_count > T9_DICT_PACKED_INDEX_MASK || word_count > T9_DICT_PACKED_INDEX_MASK ||
+        string_size == 0 || !t9_dict_section_ok(nodes_off, node_count, T9_DICT_PACKED_NODE_WORDS * 4, total) ||
+        !t9_dict_section_ok(words_off, word_count, 4, total) || !t9_dict_section_ok(strings_off, string_size, 1, total) ||
+        p[strings_off + string_size - 1] != '\0')
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open: not a packed T9 dictionary");
+        return NULL;
+    }
+
+    t9_dict_t *dict = lv_malloc_zeroed(sizeof(t9_dict_t));
+    if (dict == NULL)
+        return NULL;
+    dict->packed_nodes = (const uint32_t *)(const void *)(p + nodes_off);
+    dict->packed_words = (const uint32_t *)(const void *)(p + words_off);
+    dict->packed_strings = (const char *)(p + strings_off);
+    dict->packed_string_size = string_size;
+    dict->node_count = node_count;
+    dict->word_count = word_count;
+    LV_LOG_INFO("lv_keyboard_t9_dict_open: %d words, %d nodes", (int)word_count, (int)node_count);
+    return dict;
+}
+
+/**
+ * Delete a dictionary created with lv_keyboard_t9_dict_create or opened with lv_keyboard_t9_dict_open.
+ * It must not be linked to any keyboard anymore.
+ *
+ * @param dict Dictionary to delete
+ */
+void lv_keyboard_t9_dict_delete(t9_dict_t *dict)
+{
+    if (dict == NULL)
+        return;
+    t9_rank_sync(); // The ranking worker may be reading it
+    if (dict->map_addr)
+        t9_dict_unmap(dict);
+    lv_free(dict->nodes);
+    lv_free(dict->rank);
+    lv_free(dict->word_next);
+    lv_free(dict);
+}
+
+/**
+ * Move one step down the trie.
+ *
+ * @param dict Dictionary
+ * @param node Current node
+ * @param digit Keypad digit (2..9)
+ * @return Child node, or T9_DICT_NONE if no word continues with this digit
+ */
+uint32_t t9_dict_child(const t9_dict_t *dict, uint32_t node, uint8_t digit)
+{
+    if (dict->packed_nodes)
+    {
+        uint32_t link = dict->packed_nodes[node * T9_DICT_PACKED_NODE_WORDS];
+        uint32_t mask = link >> 24;
+        uint32_t bit = 1u << (digit - 2);
+        if ((mask & bit) == 0)
+            return T9_DICT_NONE;
+        uint32_t below = mask & (bit - 1);
+        uint32_t idx = (link & T9_DICT_PACKED_INDEX_MASK) + t9_nibble_bits[below & 0x0F] + t9_nibble_bits[below >> 4];
+        return idx < dict->node_count && idx != T9_DICT_ROOT ? idx : T9_DICT_NONE;
+    }
+    uint32_t child = dict->nodes[node].first_child;
+    while (child != T9_DICT_NONE && dict->nodes[child].digit != digit)
+        child = dict->nodes[child].next_sibling;
+    return child;
+}
+
+// String at an offset of the packed string table, NULL if out of bounds
+static const char *t9_dict_packed_string(const t9_dict_t *dict, uint32_t off)
+{
+    return off < dict->packed_string_size ? dict->packed_strings + off : NULL;
+}
+
+/**
+ * Get the best ranked word reachable from a node, its first `depth` letters
+ * match the typed sequence.
+ */
+const char *t9_dict_get_best(const t9_dict_t *dict, uint32_t node)
+{
+    if (dict->packed_nodes)
+        return t9_dict_packed_string(dict, dict->packed_nodes[node * T9_DICT_PACKED_NODE_WORDS + 2]);
+    uint32_t word = dict->nodes[node].best_word;
+    return word ? dict->words[word - 1] : NULL;
+}
+
+/**
+ * Get the exact matches of a node, best ranked first.
+ *
+ * @param out Array receiving up to `max` word pointers
+ * @return Number of words written
+ */
+uint32_t t9_dict_get_candidates(const t9_dict_t *dict, uint32_t node, const char **out, uint32_t max)
+{
+    uint32_t cnt = 0;
+    if (dict->packed_nodes)
+    {
+        uint32_t words = dict->packed_nodes[node * T9_DICT_PACKED_NODE_WORDS + 1];
+        uint32_t first = words & T9_DICT_PACKED_INDEX_MASK;
+        uint32_t end = first + (words >> 24);
+        for (uint32_t i = first; i < end && i < dict->word_count && cnt < max; i++)
+        {
+            const char *word = t9_dict_packed_string(dict, dict->packed_words[i]);
+            if (word)
+                out[cnt++] = word;
+        }
+        return cnt;
+    }
+    uint32_t word = dict->nodes[node].first_word;
+    while (word != 0 && cnt < max)
+    {
+        out[cnt++] = dict->words[word - 1];
+        word = dict->word_next[word - 1];
+    }
+    return cnt;
+}
+
+#endif // LV_KEYBOARD_T9_USE_PREDICTIVE
@@ -0,0 +1,135 @@
+/**
+ * @file lv_keyboard_t9_dict_map.c
+ * @brief Memory-mapped packed dictionaries: a flash partition on ESP-IDF, a file on POSIX hosts.
+ *
+ * The dictionary image is mapped, then opened in place with lv_keyboard_t9_dict_open, so a large
+ * dictionary costs address space but no RAM and no load time. The mapping belongs to the
+ * dictionary and is released by lv_keyboard_t9_dict_delete.
+ */
+#if !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // mmap and fstat with -std=c99
+#endif
+
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+
+#if defined(ESP_PLATFORM)
+#include "esp_partition.h"
+
+/**
+ * @brief Open the packed dictionary written to a data partition, e.g. with parttool.py write_partition.
+ * @param label Label of the partition in the partition table
+ * @return The dictionary, or NULL if the partition is missing, can not be mapped or holds no dictionary
+ */
+t9_dict_t *lv_keyboard_t9_dict_open_partition(const char *label)
+{
+    if (label == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open_partition: label is NULL");
+        return NULL;
+    }
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open_partition: no partition '%s'", label);
+        return NULL;
+    }
+
+    // Only map the dictionary, not the whole partition (MMU pages are a limited resource)
+    uint8_t header[T9_DICT_PACKED_HEADER_SIZE];
+    if (esp_partition_read(part, 0, header, sizeof(header)) != ESP_OK)
+        return NULL;
+    uint32_t size = (uint32_t)header[28] | ((uint32_t)header[29] << 8) | ((uint32_t)header[30] << 16) |
+                    ((uint32_t)header[31] << 24);
+    if (size < T9_DICT_PACKED_HEADER_SIZE || size > part->size)
+        size = part->size; // Not a dictionary, lv_keyboard_t9_dict_open reports it
+
+    const void *addr;
+    esp_partition_mmap_handle_t handle;
+    if (esp_partition_mmap(part, 0, size, ESP_PARTITION_MMAP_DATA, &addr, &handle) != ESP_OK)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open_partition: could not map '%s'", label);
+        return NULL;
+    }
+    t9_dict_t *dict = lv_keyboard_t9_dict_open(addr, size);
+    if (dict == NULL)
+    {
+        esp_partition_munmap(handle);
+        return NULL;
+    }
+    dict->map_addr = addr;
+    dict->map_size = size;
+    dict->map_handle = (uint32_t)handle;
+    return dict;
+}
+
+void t9_dict_unmap(t9_dict_t *dict)
+{
+    esp_partition_munmap((esp_partition_mmap_handle_t)dict->map_handle);
+    dict->map_addr = NULL;
+}
+
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Open a packed dictionary file (host builds, simulators), mapped read-only.
+ * @param path Path of the file generated by tools/t9_dict_gen.py
+ * @return The dictionary, or NULL if the file can not be mapped or holds no dictionary
+ */
+t9_dict_t *lv_keyboard_t9_dict_open_file(const char *path)
+{
+    if (path == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open_file: path is NULL");
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open_file: can not open %s", path);
+        return NULL;
+    }
+    struct stat st;
+    void *addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= UINT32_MAX)
+        addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file
+    if (addr == MAP_FAILED)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_dict_open_file: could not map %s", path);
+        return NULL;
+    }
+    t9_dict_t *dict = lv_keyboard_t9_dict_open(addr, (uint32_t)st.st_size);
+    if (dict == NULL)
+    {
+        munmap(addr, (size_t)st.st_size);
+        return NULL;
+    }
+    dict->map_addr = addr;
+    dict->map_size = (uint32_t)st.st_size;
+    return dict;
+}
+
+void t9_dict_unmap(t9_dict_t *dict)
+{
+    munmap((void *)(uintptr_t)dict->map_addr, dict->map_size);
+    dict->map_addr = NULL;
+}
+
+#else
+
+void t9_dict_unmap(t9_dict_t *dict)
+{
+    dict->map_addr = NULL; // No mapping helper on this platform, map_addr is never set
+}
+
+#endif
+
+#endif // LV_KEYBOARD_T9_USE_PREDICTIVE
@@ -0,0 +1,206 @@
+/**
+ * @file lv_keyboard_t9_input_trace.c
+ * @brief Input trace recording and replay of the T9 keyboard (LV_KEYBOARD_T9_USE_INPUT_TRACE).
+ *
+ * Every keyboard operation (press, long-press, popover and candidate selection) is appended to a
+ * buffer of the application as it enters its handler, so touch and keypad input record the same
+ * way. Replay feeds the records back through the same handlers with the recorded times, the
+ * multi-tap cycling then takes the same decisions as in the recorded session. Calls of the
+ * application (lv_keyboard_t9_set_textarea, insert_text...) are not recorded, only mode changes show
+ * up: each record carries the mode the keyboard had, replay sets it when it differs.
+ *
+ * Trace layout: "T9R" + version byte, then records of
+ * [input, bits 0..2 | mode, bits 3..4][btn_id, 255 if larger][ms since the previous record, LEB128].
+ * The first record has a delta of 0.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_INPUT_TRACE
+
+#define T9_INPUT_HEADER_SIZE 4
+#define T9_INPUT_RECORD_MAX (2 + 5) // Head, button and a 32 bit delta
+#define T9_INPUT_MODE_SHIFT 3
+
+static const uint8_t t9_input_magic[T9_INPUT_HEADER_SIZE] = {'T', '9', 'R', 1};
+
+// Append a record, called by the handlers before they run (lv_keyboard_t9.c)
+void t9_input_record(t9_keyboard_t *kb, lv_keyboard_t9_input_t input, uint32_t btn_id, uint32_t now)
+{
+    if (kb->rec_buf == NULL)
+        return;
+
+    uint8_t rec[T9_INPUT_RECORD_MAX];
+    uint32_t n = 0;
+    uint32_t delta = kb->rec_len == T9_INPUT_HEADER_SIZE ? 0 : now - kb->rec_time;
+    rec[n++] = (uint8_t)((uint32_t)input | ((uint32_t)kb->core.mode << T9_INPUT_MODE_SHIFT));
+    rec[n++] = (uint8_t)(btn_id > 0xFF ? 0xFF : btn_id);
+    do
+    {
+        uint8_t b = (uint8_t)(delta & 0x7F);
+        delta >>= 7;
+        rec[n++] = delta ? (uint8_t)(b | 0x80) : b;
+    } while (delta);
+
+    if (kb->rec_len + n > kb->rec_size)
+    {
+        LV_LOG_WARN("t9_input_record: trace buffer full, recording stopped");
+        kb->rec_buf = NULL;
+        return;
+    }
+    lv_memcpy(kb->rec_buf + kb->rec_len, rec, n);
+    kb->rec_len += n;
+    kb->rec_time = now;
+}
+
+/**
+ * @brief Start recording the inputs of the keyboard.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param buf Trace buffer, written until lv_keyboard_t9_record_stop or until it is full
+ * @param size Size of buf in bytes
+ * @return false if buf can not even hold the trace header
+ */
+bool lv_keyboard_t9_record_start(lv_obj_t *keyboard, uint8_t *buf, uint32_t size)
+{
+    t9_keyboard_t *kb = keyboard ? lv_obj_get_user_data(keyboard) : NULL;
+    if (kb == NULL || buf == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_record_start: keyboard or buf is NULL");
+        return false;
+    }
+    if (size < T9_INPUT_HEADER_SIZE)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_record_start: buffer too small");
+        return false;
+    }
+    lv_memcpy(buf, t9_input_magic, T9_INPUT_HEADER_SIZE);
+    kb->rec_buf = buf;
+    kb->rec_size = size;
+    kb->rec_len = T9_INPUT_HEADER_SIZE;
+    kb->rec_time = 0;
+    return true;
+}
+
+/**
+ * @brief Stop recording.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @return Size of the trace in bytes, also when recording already stopped on a full buffer
+ */
+uint32_t lv_keyboard_t9_record_stop(lv_obj_t *keyboard)
+{
+    t9_keyboard_t *kb = keyboard ? lv_obj_get_user_data(keyboard) : NULL;
+    if (kb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_record_stop: keyboard is NULL");
+        return 0;
+    }
+    kb->rec_buf = NULL;
+    return kb->rec_len;
+}
+
+/**
+ * @brief Set up the replay of a trace.
+ * @param replay Cursor to initialize
+ * @param data Trace from lv_keyboard_t9_record_start, referenced until the replay ends
+ * @param len Size of the trace in bytes
+ * @return false if data is not a trace
+ */
+bool lv_keyboard_t9_replay_init(lv_keyboard_t9_replay_t *replay, const uint8_t *data, uint32_t len)
+{
+    if (replay == NULL || data == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_replay_init: replay or data is NULL");
+        return false;
+    }
+    lv_memzero(replay, sizeof(*replay));
+    if (len < T9_INPUT_HEADER_SIZE || lv_memcmp(data, t9_input_magic, T9_INPUT_HEADER_SIZE) != 0)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_replay_init: not a T9 input trace");
+        return false;
+    }
+    replay->data = data;
+    replay->len = len;
+    replay->pos = T9_INPUT_HEADER_SIZE;
+    replay->time = lv_tick_get(); // The first record has no delay, a virtual tick stays in step
+    return true;
+}
+
+// Decode the next record, false at the end of the trace or if it is corrupt
+static bool t9_input_decode(const lv_keyboard_t9_replay_t *replay, uint8_t *head, uint8_t *btn_id,
+                            uint32_t *delta, uint32_t *size)
+{
+    const uint8_t *p = replay->data + replay->pos;
+    uint32_t left = replay->len - replay->pos;
+    if (left < 3)
+        return false;
+    *head = p[0];
+    *btn_id = p[1];
+    if ((*head & 0x07) >= LV_KEYBOARD_T9_INPUT_COUNT || (*head >> T9_INPUT_MODE_SHIFT) > T9_MODE_PREDICTIVE)
+        return false;
+
+    uint32_t value = 0;
+    uint32_t n = 2;
+    for (uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        if (n == left)
+            return false;
+        uint8_t b = p[n++];
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+        {
+            *delta = value;
+            *size = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lv_keyboard_t9_replay_peek(const lv_keyboard_t9_replay_t *replay, uint32_t *delay_ms)
+{
+    if (replay == NULL || replay->data == NULL)
+        return false;
+    uint8_t head, btn_id;
+    uint32_t delta, size;
+    if (!t9_input_decode(replay, &head, &btn_id, &delta, &size))
+        return false;
+    if (delay_ms)
+        *delay_ms = delta;
+    return true;
+}
+
+/**
+ * @brief Replay the next record of a trace.
+ * @param keyboard Pointer to the T9 keyboard object, linked to the textarea to type into
+ * @param replay Cursor from lv_keyboard_t9_replay_init
+ * @return false at the end of the trace or on a corrupt record
+ */
+bool lv_keyboard_t9_replay_step(lv_obj_t *keyboard, lv_keyboard_t9_replay_t *replay)
+{
+    t9_keyboard_t *kb = keyboard ? lv_obj_get_user_data(keyboard) : NULL;
+    if (kb == NULL || replay == NULL || replay->data == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_replay_step: keyboard or replay is NULL");
+        return false;
+    }
+    uint8_t head, btn_id;
+    uint32_t delta, size;
+    if (!t9_input_decode(replay, &head, &btn_id, &delta, &size))
+        return false;
+    replay->pos += size;
+    replay->time += delta;
+
+    t9_mode_t mode = (t9_mode_t)(head >> T9_INPUT_MODE_SHIFT);
+    if (kb->core.mode != mode)
+    {
+        // Set by the application in the recorded session
+        lv_keyboard_t9_set_mode(keyboard, mode);
+        replay->resyncs++;
+    }
+    t9_input_apply(kb, (lv_keyboard_t9_input_t)(head & 0x07), btn_id, replay->time);
+    replay->events++;
+    return true;
+}
+
+#endif // LV_KEYBOARD_T9_USE_INPUT_TRACE
@@ -0,0 +1,248 @@
+/**
+ * @file lv_keyboard_t9_key_cache.c
+ * @brief Cached idle key images of the T9 keyboard (LV_KEYBOARD_T9_USE_KEY_CACHE).
+ *
+ * Without a GPU every redraw of the keyboard matrix rasterizes the rounded backgrounds and labels of
+ * all the keys it touches. With the cache the idle matrix of a mode is rendered once with
+ * lv_snapshot into a slot; while an image matches the mode and size of the matrix it is blitted
+ * under the matrix in LV_EVENT_DRAW_MAIN_BEGIN and the idle keys, background and border of the matrix
+ * are made transparent by styles, so only the pressed or keypad-selected key is drawn over it.
+ *
+ * A missing image is rendered by a timer once no key is pressed (the image must not show the
+ * pressed mode key), the matrix draws all its keys until then. Mode switches between cached modes
+ * only redraw the keys whose label changes, like without the cache. The shadow and outline around
+ * the matrix stay live, the image is clipped to the matrix area.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+
+// Shared like t9_style_helper, the live key opacities are read from the first keyboard
+static lv_style_t t9_style_idle_main;  // Matrix background and border, in the image
+static lv_style_t t9_style_idle_items; // Idle keys, in the image
+static lv_style_t t9_style_live_items; // Pressed and selected keys, drawn over the image
+static bool t9_key_cache_styles_inited = false;
+
+static void t9_key_cache_styles_init(lv_obj_t *btnmatrix)
+{
+    if (t9_key_cache_styles_inited)
+        return;
+    lv_style_init(&t9_style_idle_main);
+    lv_style_set_bg_opa(&t9_style_idle_main, LV_OPA_TRANSP);
+    lv_style_set_border_opa(&t9_style_idle_main, LV_OPA_TRANSP);
+
+    lv_style_init(&t9_style_idle_items);
+    lv_style_set_bg_opa(&t9_style_idle_items, LV_OPA_TRANSP);
+    lv_style_set_border_opa(&t9_style_idle_items, LV_OPA_TRANSP);
+    lv_style_set_shadow_opa(&t9_style_idle_items, LV_OPA_TRANSP);
+    lv_style_set_text_opa(&t9_style_idle_items, LV_OPA_TRANSP);
+
+    lv_style_init(&t9_style_live_items);
+    lv_style_set_bg_opa(&t9_style_live_items, lv_obj_get_style_bg_opa(btnmatrix, LV_PART_ITEMS));
+    lv_style_set_border_opa(&t9_style_live_items, lv_obj_get_style_border_opa(btnmatrix, LV_PART_ITEMS));
+    lv_style_set_shadow_opa(&t9_style_live_items, lv_obj_get_style_shadow_opa(btnmatrix, LV_PART_ITEMS));
+    lv_style_set_text_opa(&t9_style_live_items, lv_obj_get_style_text_opa(btnmatrix, LV_PART_ITEMS));
+    t9_key_cache_styles_inited = true;
+}
+
+/*
+ * Draw the matrix over the image of a slot, or all of it (slot -1). Adding or removing the styles
+ * invalidates the whole matrix, switching between two images does not: their keys only differ by
+ * the labels that t9_update_btnmatrix_labels already invalidated.
+ */
+static void t9_key_cache_show(t9_keyboard_t *kb, int8_t slot)
+{
+    bool was_cached = kb->key_cache_slot >= 0;
+    kb->key_cache_slot = slot;
+    if ((slot >= 0) == was_cached)
+        return;
+    lv_obj_t *btnmatrix = kb->btnmatrix;
+    if (slot >= 0)
+    {
+        // Higher states win in LVGL: the live style beats the idle one on pressed helper keys too
+        lv_obj_add_style(btnmatrix, &t9_style_idle_main, LV_PART_MAIN);
+        lv_obj_add_style(btnmatrix, &t9_style_idle_items, LV_PART_ITEMS);
+        lv_obj_add_style(btnmatrix, &t9_style_idle_items, LV_PART_ITEMS | LV_STATE_CHECKED); // Over t9_style_helper
+        lv_obj_add_style(btnmatrix, &t9_style_live_items, LV_PART_ITEMS | LV_STATE_PRESSED);
+        lv_obj_add_style(btnmatrix, &t9_style_live_items, LV_PART_ITEMS | LV_STATE_FOCUS_KEY);
+    }
+    else
+    {
+        lv_obj_remove_style(btnmatrix, &t9_style_idle_main, LV_PART_ANY | LV_STATE_ANY);
+        lv_obj_remove_style(btnmatrix, &t9_style_idle_items, LV_PART_ANY | LV_STATE_ANY);
+        lv_obj_remove_style(btnmatrix, &t9_style_live_items, LV_PART_ANY | LV_STATE_ANY);
+    }
+}
+
+static int8_t t9_key_cache_find(const t9_keyboard_t *kb, int32_t w, int32_t h)
+{
+    for (int8_t i = 0; i < T9_KEY_CACHE_SLOTS; i++)
+    {
+        const t9_key_cache_slot_t *slot = &kb->key_cache[i];
+        if (slot->valid && slot->mode == kb->core.mode && slot->w == w && slot->h == h)
+            return i;
+    }
+    return -1;
+}
+
+// Slot to render the image of the mode into: its stale image, a free slot, else the next victim
+static int8_t t9_key_cache_pick(t9_keyboard_t *kb)
+{
+    for (int8_t i = 0; i < T9_KEY_CACHE_SLOTS; i++)
+    {
+        if (kb->key_cache[i].buf && kb->key_cache[i].mode == kb->core.mode)
+            return i;
+    }
+    for (int8_t i = 0; i < T9_KEY_CACHE_SLOTS; i++)
+    {
+        if (kb->key_cache[i].buf == NULL)
+            return i;
+    }
+    int8_t victim = (int8_t)kb->key_cache_victim;
+    kb->key_cache_victim = (uint8_t)((victim + 1) % T9_KEY_CACHE_SLOTS);
+    return victim;
+}
+
+// Render the idle matrix of the current mode, the existing buffer of the slot is reused when large enough
+static void t9_key_cache_timer_cb(lv_timer_t *timer)
+{
+    t9_keyboard_t *kb = lv_timer_get_user_data(timer);
+    lv_obj_t *btnmatrix = kb->btnmatrix;
+    if (lv_obj_has_state(btnmatrix, LV_STATE_PRESSED))
+        return; // Retried on the next period
+    lv_timer_pause(timer);
+    int32_t w = lv_obj_get_width(btnmatrix);
+    int32_t h = lv_obj_get_height(btnmatrix);
+    if (kb->key_cache_slot >= 0 || w <= 0 || h <= 0)
+        return; // Not laid out yet, LV_EVENT_SIZE_CHANGED resumes the timer
+
+    int8_t idx = t9_key_cache_pick(kb);
+    t9_key_cache_slot_t *slot = &kb->key_cache[idx];
+    slot->valid = false;
+    if (slot->buf && lv_snapshot_reshape_draw_buf(btnmatrix, slot->buf) != LV_RESULT_OK)
+    {
+        lv_draw_buf_destroy(slot->buf);
+        slot->buf = NULL;
+    }
+    if (slot->buf == NULL)
+        slot->buf = lv_snapshot_create_draw_buf(btnmatrix, T9_KEY_CACHE_CF);
+    if (slot->buf == NULL)
+    {
+        LV_LOG_WARN("t9_key_cache_timer_cb: out of memory, keys drawn without cache");
+        return;
+    }
+
+    // No selected key in the image, the keypad highlight is drawn live
+    uint32_t sel = lv_buttonmatrix_get_selected_button(btnmatrix);
+    if (sel != LV_BUTTONMATRIX_BUTTON_NONE)
+        lv_buttonmatrix_set_selected_button(btnmatrix, LV_BUTTONMATRIX_BUTTON_NONE);
+    lv_result_t res = lv_snapshot_take_to_draw_buf(btnmatrix, T9_KEY_CACHE_CF, slot->buf);
+    if (sel != LV_BUTTONMATRIX_BUTTON_NONE)
+        lv_buttonmatrix_set_selected_button(btnmatrix, sel);
+    if (res != LV_RESULT_OK)
+    {
+        LV_LOG_WARN("t9_key_cache_timer_cb: snapshot failed, keys drawn without cache");
+        return;
+    }
+
+    slot->w = w;
+    slot->h = h;
+    slot->ext = lv_obj_get_ext_draw_size(btnmatrix);
+    slot->mode = kb->core.mode;
+    slot->valid = true;
+    T9_STAT_INC(kb, key_cache_builds);
+    t9_key_cache_show(kb, idx);
+}
+
+// Blit the image under the matrix, before its (transparent) background and keys are drawn
+static void t9_key_cache_draw_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    if (kb->key_cache_slot < 0)
+        return;
+    const t9_key_cache_slot_t *slot = &kb->key_cache[kb->key_cache_slot];
+    lv_layer_t *layer = lv_event_get_layer(e);
+
+    lv_area_t coords;
+    lv_area_t clip;
+    lv_obj_get_coords(kb->btnmatrix, &coords);
+    if (!lv_area_intersect(&clip, &layer->_clip_area, &coords))
+        return;
+    lv_area_t area = coords;
+    lv_area_increase(&area, slot->ext, slot->ext);
+
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.src = slot->buf;
+    lv_area_t clip_ori = layer->_clip_area;
+    layer->_clip_area = clip; // The shadow and outline of the image are drawn live by the matrix
+    lv_draw_image(layer, &dsc, &area);
+    layer->_clip_area = clip_ori;
+}
+
+static void t9_key_cache_size_cb(lv_event_t *e)
+{
+    t9_key_cache_sync(lv_event_get_user_data(e));
+}
+
+// Set up the cache of a new keyboard, before its first layout is applied
+void t9_key_cache_attach(t9_keyboard_t *kb)
+{
+    t9_key_cache_styles_init(kb->btnmatrix);
+    kb->key_cache_slot = -1;
+    kb->key_cache_timer = lv_timer_create(t9_key_cache_timer_cb, T9_KEY_CACHE_DELAY_MS, kb);
+    lv_timer_pause(kb->key_cache_timer);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_key_cache_draw_cb, LV_EVENT_DRAW_MAIN_BEGIN, kb);
+    lv_obj_add_event_cb(kb->btnmatrix, t9_key_cache_size_cb, LV_EVENT_SIZE_CHANGED, kb);
+}
+
+// Free the images with the keyboard
+void t9_key_cache_detach(t9_keyboard_t *kb)
+{
+    if (kb->key_cache_timer)
+        lv_timer_delete(kb->key_cache_timer);
+    for (int i = 0; i < T9_KEY_CACHE_SLOTS; i++)
+    {
+        if (kb->key_cache[i].buf)
+            lv_draw_buf_destroy(kb->key_cache[i].buf);
+    }
+}
+
+// Draw over the image of the mode if there is one, else draw all the keys until it is rendered
+void t9_key_cache_sync(t9_keyboard_t *kb)
+{
+    if (kb->key_cache_timer == NULL)
+        return;
+    int8_t slot = t9_key_cache_find(kb, lv_obj_get_width(kb->btnmatrix), lv_obj_get_height(kb->btnmatrix));
+    t9_key_cache_show(kb, slot);
+    if (slot >= 0)
+    {
+        lv_timer_pause(kb->key_cache_timer);
+        return;
+    }
+    lv_timer_reset(kb->key_cache_timer);
+    lv_timer_resume(kb->key_cache_timer);
+}
+
+// The look of the keys changed (charset, layout, theme...), render all the images again when used
+void t9_key_cache_invalidate(t9_keyboard_t *kb)
+{
+    for (int i = 0; i < T9_KEY_CACHE_SLOTS; i++)
+        kb->key_cache[i].valid = false;
+    t9_key_cache_sync(kb);
+}
+
+void lv_keyboard_t9_invalidate_key_cache(lv_obj_t *keyboard)
+{
+    t9_keyboard_t *kb = keyboard ? lv_obj_get_user_data(keyboard) : NULL;
+    if (kb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_invalidate_key_cache: keyboard is NULL");
+        return;
+    }
+    t9_key_cache_invalidate(kb);
+}
+
+#endif // LV_KEYBOARD_T9_USE_KEY_CACHE
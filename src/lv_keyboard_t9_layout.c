@@ -0,0 +1,98 @@
+/**
+ * @file lv_keyboard_t9_layout.c
+ * @brief Built-in keyboard layouts, expanded at compile time from the descriptions of lv_keyboard_t9_private.h.
+ *
+ * Every description is expanded several times with other ROW macros: into an enum numbering its
+ * buttons (btn_id), then into the btn_id -> key, key -> btn_id and btn_id -> grid cell tables and
+ * one buttonmatrix map per mode. All of it is const, a layout only costs flash and the keyboard
+ * maps a button or a key with one array index.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#define T9_CAT(a, b) T9_CAT_(a, b)
+#define T9_CAT_(a, b) a##b
+
+// Call F(X, row, col, cols, key) for every key of a row
+#define T9_FOREACH(F, X, row, ...) \
+    T9_CAT(T9_FOREACH_, T9_NARGS(__VA_ARGS__))(F, X, row, T9_NARGS(__VA_ARGS__), __VA_ARGS__)
+#define T9_FOREACH_1(F, X, row, n, k) F(X, row, n - 1, n, k)
+#define T9_FOREACH_2(F, X, row, n, k, ...) F(X, row, n - 2, n, k) T9_FOREACH_1(F, X, row, n, __VA_ARGS__)
+#define T9_FOREACH_3(F, X, row, n, k, ...) F(X, row, n - 3, n, k) T9_FOREACH_2(F, X, row, n, __VA_ARGS__)
+#define T9_FOREACH_4(F, X, row, n, k, ...) F(X, row, n - 4, n, k) T9_FOREACH_3(F, X, row, n, __VA_ARGS__)
+#define T9_FOREACH_5(F, X, row, n, k, ...) F(X, row, n - 5, n, k) T9_FOREACH_4(F, X, row, n, __VA_ARGS__)
+#define T9_FOREACH_6(F, X, row, n, k, ...) F(X, row, n - 6, n, k) T9_FOREACH_5(F, X, row, n, __VA_ARGS__)
+
+// Labels of every key in each t9_mode_t (lower, upper, numbers, predictive). The letter modes show
+// the labels of the charset pack on the T9 keys instead.
+#define T9_LABELS_1 "1:;...", "1:;...", "1", "1:;..."
+#define T9_LABELS_2 "abc2", "ABC2", "2", "abc2"
+#define T9_LABELS_3 "def3", "DEF3", "3", "def3"
+#define T9_LABELS_4 "ghi4", "GHI4", "4", "ghi4"
+#define T9_LABELS_5 "jkl5", "JKL5", "5", "jkl5"
+#define T9_LABELS_6 "mno6", "MNO6", "6", "mno6"
+#define T9_LABELS_7 "pqrs7", "PQRS7", "7", "pqrs7"
+#define T9_LABELS_8 "tuv8", "TUV8", "8", "tuv8"
+#define T9_LABELS_9 "wxyz9", "WXYZ9", "9", "wxyz9"
+#define T9_LABELS_0 "0!\"...", "0!\"...", "0", "0!\"..."
+#define T9_LABELS_BACKSPACE LV_SYMBOL_BACKSPACE, LV_SYMBOL_BACKSPACE, LV_SYMBOL_BACKSPACE, LV_SYMBOL_BACKSPACE
+#define T9_LABELS_OK LV_SYMBOL_OK, LV_SYMBOL_OK, LV_SYMBOL_OK, LV_SYMBOL_OK
+#define T9_LABELS_CLOSE LV_SYMBOL_CLOSE, LV_SYMBOL_CLOSE, LV_SYMBOL_CLOSE, LV_SYMBOL_CLOSE
+#define T9_LABELS_SPACE "space", "space", "space", "space"
+#define T9_LABELS_CASE "abc", "ABC", "abc", "abc"
+#define T9_LABELS_MODE "T9", "T9", "123", "T9+"
+#define T9_LABELS_SHIFT LV_SYMBOL_UP, LV_SYMBOL_UP, LV_SYMBOL_UP, LV_SYMBOL_UP
+
+#define T9_PICK_0(lower, upper, numbers, predictive) lower
+#define T9_PICK_1(lower, upper, numbers, predictive) upper
+#define T9_PICK_2(lower, upper, numbers, predictive) numbers
+#define T9_PICK_3(lower, upper, numbers, predictive) predictive
+#define T9_LABEL(mode, labels) T9_CAT(T9_PICK_, mode)(labels)
+
+#define T9_BREAK_0
+#define T9_BREAK_1 "\n",
+#define T9_BREAK_2 "\n",
+#define T9_BREAK_3 "\n",
+#define T9_BREAK_4 "\n",
+#define T9_BREAK_5 "\n",
+#define T9_BREAK_6 "\n",
+#define T9_BREAK_7 "\n",
+
+// ROW expanders, X is the layout name (or the mode for the maps)
+#define T9_GEN_ID(X, row, col, cols, k) T9_ID_##X##_##k,
+#define T9_GEN_ID_ROW(X, row, ...) T9_FOREACH(T9_GEN_ID, X, row, __VA_ARGS__)
+#define T9_GEN_KEY(X, row, col, cols, k) LV_KEYBOARD_T9_KEY_##k,
+#define T9_GEN_KEY_ROW(X, row, ...) T9_FOREACH(T9_GEN_KEY, X, row, __VA_ARGS__)
+#define T9_GEN_BTN(X, row, col, cols, k) [LV_KEYBOARD_T9_KEY_##k] = T9_ID_##X##_##k + 1,
+#define T9_GEN_BTN_ROW(X, row, ...) T9_FOREACH(T9_GEN_BTN, X, row, __VA_ARGS__)
+#define T9_GEN_CELL(X, row, col, cols, k) {row, col, cols},
+#define T9_GEN_CELL_ROW(X, row, ...) T9_FOREACH(T9_GEN_CELL, X, row, __VA_ARGS__)
+#define T9_GEN_LABEL(X, row, col, cols, k) T9_LABEL(X, T9_LABELS_##k),
+#define T9_GEN_MAP_ROW(X, row, ...) T9_CAT(T9_BREAK_, row) T9_FOREACH(T9_GEN_LABEL, X, row, __VA_ARGS__)
+#define T9_GEN_ONE_ROW(X, row, ...) 1 +
+
+#define T9_LAYOUT_DEFINE(name, layout)                                                        \
+    enum                                                                                      \
+    {                                                                                         \
+        layout(T9_GEN_ID_ROW, name) T9_ID_##name##_COUNT                                      \
+    };                                                                                        \
+    static const char *const t9_layout_##name##_lower[] = {layout(T9_GEN_MAP_ROW, 0) NULL};   \
+    static const char *const t9_layout_##name##_upper[] = {layout(T9_GEN_MAP_ROW, 1) NULL};   \
+    static const char *const t9_layout_##name##_numbers[] = {layout(T9_GEN_MAP_ROW, 2) NULL}; \
+    static const char *const t9_layout_##name##_pred[] = {layout(T9_GEN_MAP_ROW, 3) NULL};    \
+    static const uint8_t t9_layout_##name##_keys[] = {layout(T9_GEN_KEY_ROW, name)};          \
+    static const t9_layout_cell_t t9_layout_##name##_cells[] = {layout(T9_GEN_CELL_ROW, name)};\
+    const t9_layout_t lv_keyboard_t9_layout_##name = {                                        \
+        {t9_layout_##name##_lower, t9_layout_##name##_upper, t9_layout_##name##_numbers,      \
+         t9_layout_##name##_pred},                                                            \
+        t9_layout_##name##_keys,                                                              \
+        t9_layout_##name##_cells,                                                             \
+        {layout(T9_GEN_BTN_ROW, name)},                                                       \
+        T9_ID_##name##_COUNT,                                                                 \
+        (layout(T9_GEN_ONE_ROW, name) 0),                                                     \
+    }
+
+T9_LAYOUT_DEFINE(4x4, T9_LAYOUT_4X4);
+T9_LAYOUT_DEFINE(phone, T9_LAYOUT_PHONE);
+T9_LAYOUT_DEFINE(5col, T9_LAYOUT_5COL);
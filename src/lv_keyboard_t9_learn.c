@@ -0,0 +1,402 @@
+/**
+ * @file lv_keyboard_t9_learn.c
+ * @brief User-learned words of the T9 keyboard predictive mode, persisted in an append-only log.
+ *
+ * Confirmed words are counted in a fixed size RAM table (the memory budget) and their records are
+ * buffered, then appended to the log in one write after T9_LEARN_FLUSH_MS idle or when the buffer
+ * is full. Nothing is ever rewritten in place: when the log reaches its capacity it is erased and
+ * written again with one record per word (compaction). At startup the log is replayed into the table.
+ *
+ * Log layout: "T9L" + version byte, then records of [length][count, 16 bit LE][lower case letters].
+ * Replay stops at the first erased (0xFF) or invalid byte, an invalid tail is compacted away.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+
+#define T9_LEARN_HEADER_SIZE 4
+#define T9_LEARN_RECORD_HEAD 3
+#define T9_LEARN_RECORD_MAX (T9_LEARN_RECORD_HEAD + T9_PRED_MAX_DEPTH)
+#define T9_LEARN_READ_CHUNK 256
+
+static const uint8_t t9_learn_magic[T9_LEARN_HEADER_SIZE] = {'T', '9', 'L', 1};
+
+static void t9_learn_flush_timer_cb(lv_timer_t *timer);
+
+static t9_learn_entry_t *t9_learn_find(t9_learn_t *learn, const char *word, uint32_t len)
+{
+    for (uint32_t i = 0; i < learn->entry_cnt; i++)
+    {
+        t9_learn_entry_t *e = &learn->entries[i];
+        if (e->len == len && lv_memcmp(e->word, word, len) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+// Count a word in the RAM table, the least confirmed word makes room when the budget is used up
+static void t9_learn_add(t9_learn_t *learn, const char *word, uint32_t len, uint32_t count)
+{
+    t9_learn_entry_t *e = t9_learn_find(learn, word, len);
+    if (e == NULL)
+    {
+        if (learn->entry_cnt < learn->entry_max)
+        {
+            e = &learn->entries[learn->entry_cnt++];
+        }
+        else
+        {
+            e = &learn->entries[0];
+            for (uint32_t i = 1; i < learn->entry_cnt; i++)
+            {
+                if (learn->entries[i].count < e->count)
+                    e = &learn->entries[i];
+            }
+        }
+        lv_memcpy(e->word, word, len);
+        e->word[len] = '\0';
+        e->len = (uint8_t)len;
+        e->count = 0;
+    }
+    count += e->count;
+    e->count = (uint16_t)(count > UINT16_MAX ? UINT16_MAX : count);
+}
+
+static uint32_t t9_learn_put_record(uint8_t *buf, const char *word, uint32_t len, uint32_t count)
+{
+    buf[0] = (uint8_t)len;
+    buf[1] = (uint8_t)(count & 0xFF);
+    buf[2] = (uint8_t)(count >> 8);
+    lv_memcpy(&buf[T9_LEARN_RECORD_HEAD], word, len);
+    return T9_LEARN_RECORD_HEAD + len;
+}
+
+// Lower case a-z only, anything else is not a record written by this module
+static bool t9_learn_valid_word(const uint8_t *word, uint32_t len)
+{
+    if (len < T9_LEARN_MIN_LEN || len > T9_PRED_MAX_DEPTH)
+        return false;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        if (word[i] < 'a' || word[i] > 'z')
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Replay the log into the RAM table, reading it by chunks.
+ *
+ * @return false if the log ends with an invalid (not erased) tail and must be compacted
+ */
+static bool t9_learn_replay(t9_learn_t *learn)
+{
+    uint8_t header[T9_LEARN_HEADER_SIZE];
+    if (learn->io.read(learn->io.ctx, 0, header, sizeof(header)) != sizeof(header) ||
+        lv_memcmp(header, t9_learn_magic, sizeof(header)) != 0)
+    {
+        learn->log_end = 0; // Empty or foreign data, the first flush starts a new log
+        return true;
+    }
+
+    uint8_t buf[T9_LEARN_READ_CHUNK];
+    uint32_t buf_pos = T9_LEARN_HEADER_SIZE; // Log offset of buf[0]
+    uint32_t have = 0;
+    uint32_t p = 0;
+    bool eof = false;
+    bool valid = true;
+    uint32_t records = 0;
+    for (;;)
+    {
+        if (have - p < T9_LEARN_RECORD_MAX && !eof)
+        {
+            // Keep the unparsed bytes and refill the chunk
+            lv_memmove(buf, &buf[p], have - p);
+            buf_pos += p;
+            have -= p;
+            p = 0;
+            uint32_t want = sizeof(buf) - have;
+            uint32_t n = learn->io.read(learn->io.ctx, buf_pos + have, &buf[have], want);
+            if (n < want)
+                eof = true;
+            have += n;
+        }
+        uint32_t left = have - p;
+        if (left == 0 || buf[p] == 0xFF)
+            break; // End of the data or erased flash
+        uint32_t len = buf[p];
+        if (left < T9_LEARN_RECORD_HEAD + len || !t9_learn_valid_word(&buf[p + T9_LEARN_RECORD_HEAD], len))
+        {
+            valid = false;
+            break;
+        }
+        uint32_t count = (uint32_t)buf[p + 1] | ((uint32_t)buf[p + 2] << 8);
+        t9_learn_add(learn, (const char *)&buf[p + T9_LEARN_RECORD_HEAD], len, count);
+        p += T9_LEARN_RECORD_HEAD + len;
+        records++;
+    }
+    learn->log_end = buf_pos + p;
+    LV_LOG_INFO("t9_learn_replay: %d records, %d words, %d bytes", (int)records, (int)learn->entry_cnt,
+                (int)learn->log_end);
+    return valid;
+}
+
+/**
+ * Create the learned words.
+ *
+ * @param budget_bytes RAM for the words (about 36 bytes each), the least confirmed words are replaced when full
+ * @param io Log storage, copied, or NULL to keep the words in RAM only
+ * @return The learned words, or NULL on allocation failure or a too small budget
+ */
+t9_learn_t *lv_keyboard_t9_learn_create(uint32_t budget_bytes, const lv_keyboard_t9_learn_io_t *io)
+{
+    uint32_t entry_max = budget_bytes / sizeof(t9_learn_entry_t);
+    if (entry_max == 0)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_learn_create: budget too small");
+        return NULL;
+    }
+    if (io && (io->read == NULL || io->append == NULL || io->erase == NULL))
+    {
+        LV_LOG_WARN("lv_keyboard_t9_learn_create: incomplete io");
+        return NULL;
+    }
+
+    t9_learn_t *learn = lv_malloc_zeroed(sizeof(t9_learn_t));
+    if (learn == NULL)
+        return NULL;
+    learn->entries = lv_malloc_zeroed(entry_max * sizeof(t9_learn_entry_t));
+    if (learn->entries == NULL)
+    {
+        lv_free(learn);
+        return NULL;
+    }
+    learn->entry_max = entry_max;
+
+    if (io)
+    {
+        learn->io = *io;
+        learn->has_io = true;
+        learn->flush_timer = lv_timer_create(t9_learn_flush_timer_cb, T9_LEARN_FLUSH_MS, learn);
+        if (learn->flush_timer)
+            lv_timer_pause(learn->flush_timer);
+        if (!t9_learn_replay(learn))
+        {
+            LV_LOG_WARN("lv_keyboard_t9_learn_create: invalid log tail, compacting");
+            lv_keyboard_t9_learn_compact(learn);
+        }
+    }
+    return learn;
+}
+
+/**
+ * Delete the learned words, buffered words are appended to the log first.
+ *
+ * @param learn Learned words to delete
+ */
+void lv_keyboard_t9_learn_delete(t9_learn_t *learn)
+{
+    if (learn == NULL)
+        return;
+    t9_rank_sync(); // The ranking worker may be reading it
+    lv_keyboard_t9_learn_flush(learn);
+    if (learn->flush_timer)
+        lv_timer_delete(learn->flush_timer);
+    lv_free(learn->entries);
+    lv_free(learn);
+}
+
+// Buffer the record of a confirmed word, appended on the next flush
+static void t9_learn_queue(t9_learn_t *learn, const char *word, uint32_t len)
+{
+    if (!learn->has_io)
+        return;
+    if (learn->pending_len + T9_LEARN_RECORD_HEAD + len > sizeof(learn->pending))
+        lv_keyboard_t9_learn_flush(learn);
+    learn->pending_len += t9_learn_put_record(&learn->pending[learn->pending_len], word, len, 1);
+    if (learn->flush_timer)
+    {
+        lv_timer_reset(learn->flush_timer);
+        lv_timer_resume(learn->flush_timer);
+    }
+}
+
+/**
+ * Learn the words of a text. Words are runs of ASCII letters between spaces or punctuation,
+ * learned in lower case; runs with digits or non-ASCII chars can not be typed in the predictive
+ * mode and are skipped, as well as the words shorter than T9_LEARN_MIN_LEN.
+ *
+ * @param learn Learned words
+ * @param text UTF-8 text
+ */
+void lv_keyboard_t9_learn_text(t9_learn_t *learn, const char *text)
+{
+    if (learn == NULL || text == NULL)
+        return;
+    t9_rank_sync(); // The table is changed below while the ranking worker may be reading it
+    const char *c = text;
+    while (*c != '\0')
+    {
+        // Token: letters, digits and any non-ASCII byte
+        const char *start = c;
+        bool letters = true;
+        while (*c != '\0')
+        {
+            uint8_t b = (uint8_t)*c;
+            bool letter = (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z');
+            if (!letter && b < 0x80 && !(b >= '0' && b <= '9'))
+                break;
+            letters = letters && letter;
+            c++;
+        }
+        uint32_t len = (uint32_t)(c - start);
+        if (letters && len >= T9_LEARN_MIN_LEN && len <= T9_PRED_MAX_DEPTH)
+        {
+            char word[T9_PRED_MAX_DEPTH];
+            for (uint32_t i = 0; i < len; i++)
+            {
+                char l = start[i];
+                word[i] = (l >= 'A' && l <= 'Z') ? (char)(l - 'A' + 'a') : l;
+            }
+            // Queued first: a flush it triggers may compact, and the snapshot must not count it yet
+            t9_learn_queue(learn, word, len);
+            t9_learn_add(learn, word, len, 1);
+        }
+        if (*c != '\0')
+            c++; // Separator
+    }
+}
+
+/**
+ * Append the buffered records to the log with a single write. When the log would grow past
+ * its capacity it is compacted instead (the RAM table already counts the buffered words).
+ *
+ * @param learn Learned words
+ * @return false if the storage failed, the log is then rewritten on the next flush
+ */
+bool lv_keyboard_t9_learn_flush(t9_learn_t *learn)
+{
+    if (learn == NULL)
+        return false;
+    if (learn->flush_timer)
+        lv_timer_pause(learn->flush_timer);
+    if (learn->pending_len == 0 || !learn->has_io)
+    {
+        learn->pending_len = 0;
+        return true;
+    }
+    if (learn->log_end == 0 || learn->log_end + learn->pending_len > learn->io.capacity)
+        return lv_keyboard_t9_learn_compact(learn);
+
+    bool ok = learn->io.append(learn->io.ctx, learn->log_end, learn->pending, learn->pending_len);
+    if (ok)
+        learn->log_end += learn->pending_len;
+    else
+        learn->log_end = 0; // Unknown state after a failed write, start over
+    learn->pending_len = 0;
+    return ok;
+}
+
+/**
+ * Erase the log and write one record per learned word. The pending buffer is reused for the
+ * writes, so this only needs log capacity / T9_LEARN_BATCH appends.
+ *
+ * @param learn Learned words
+ * @return false if the storage failed
+ */
+bool lv_keyboard_t9_learn_compact(t9_learn_t *learn)
+{
+    if (learn == NULL)
+        return false;
+    learn->pending_len = 0;
+    if (!learn->has_io)
+        return true;
+    if (learn->flush_timer)
+        lv_timer_pause(learn->flush_timer);
+
+    learn->log_end = 0;
+    if (!learn->io.erase(learn->io.ctx))
+        return false;
+
+    uint8_t *buf = learn->pending;
+    uint32_t off = 0;
+    uint32_t len = T9_LEARN_HEADER_SIZE;
+    lv_memcpy(buf, t9_learn_magic, T9_LEARN_HEADER_SIZE);
+    for (uint32_t i = 0; i < learn->entry_cnt; i++)
+    {
+        const t9_learn_entry_t *e = &learn->entries[i];
+        uint32_t rec = T9_LEARN_RECORD_HEAD + e->len;
+        if (off + len + rec > learn->io.capacity)
+        {
+            LV_LOG_WARN("lv_keyboard_t9_learn_compact: log capacity too small for the budget");
+            break;
+        }
+        if (len + rec > sizeof(learn->pending))
+        {
+            if (!learn->io.append(learn->io.ctx, off, buf, len))
+                return false;
+            off += len;
+            len = 0;
+        }
+        len += t9_learn_put_record(&buf[len], e->word, e->len, e->count);
+    }
+    if (!learn->io.append(learn->io.ctx, off, buf, len))
+        return false;
+    learn->log_end = off + len;
+    return true;
+}
+
+static void t9_learn_flush_timer_cb(lv_timer_t *timer)
+{
+    lv_keyboard_t9_learn_flush(lv_timer_get_user_data(timer));
+}
+
+/**
+ * Get the learned words typed with a digit sequence, most confirmed first.
+ *
+ * @param digits Keypad digits (2..9)
+ * @param len Number of digits
+ * @param out Receives up to max word pointers (valid until the table changes)
+ * @return Number of words written
+ */
+uint32_t t9_learn_get_candidates(const t9_learn_t *learn, const uint8_t *digits, uint8_t len, const char **out,
+                                 uint32_t max)
+{
+    uint16_t counts[T9_PRED_CANDIDATES];
+    uint32_t cnt = 0;
+    if (max > T9_PRED_CANDIDATES)
+        max = T9_PRED_CANDIDATES;
+    for (uint32_t i = 0; i < learn->entry_cnt; i++)
+    {
+        const t9_learn_entry_t *e = &learn->entries[i];
+        if (e->len != len || e->count == 0)
+            continue;
+        uint8_t j = 0;
+        while (j < len && t9_dict_letter_digit(e->word[j]) == digits[j])
+            j++;
+        if (j < len)
+            continue;
+
+        // Insertion into the short sorted list
+        uint32_t pos = cnt;
+        while (pos > 0 && counts[pos - 1] < e->count)
+            pos--;
+        if (pos >= max)
+            continue;
+        uint32_t last = (cnt < max) ? cnt : max - 1;
+        for (uint32_t k = last; k > pos; k--)
+        {
+            out[k] = out[k - 1];
+            counts[k] = counts[k - 1];
+        }
+        out[pos] = e->word;
+        counts[pos] = e->count;
+        if (cnt < max)
+            cnt++;
+    }
+    return cnt;
+}
+
+#endif // LV_KEYBOARD_T9_USE_PREDICTIVE
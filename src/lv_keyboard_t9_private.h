@@ -0,0 +1,543 @@
+/**
+ * @file lv_keyboard_t9_private.h
+ * @brief Internal declarations shared between the T9 keyboard translation units.
+ *
+ * Not part of the public API, do not include from application code.
+ */
+#ifndef LV_KEYBOARD_T9_PRIVATE_H
+#define LV_KEYBOARD_T9_PRIVATE_H
+
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Index of the root node, it is never the child of another node so 0 also means "no node"
+#define T9_DICT_ROOT 0
+#define T9_DICT_NONE 0
+
+/**
+ * Node of the digit trie. Every edge is one keypad digit ('2'..'9'), so a node
+ * has at most 8 children kept as a first-child / next-sibling list.
+ */
+typedef struct
+{
+    uint32_t first_child;  // Node index, T9_DICT_NONE if leaf
+    uint32_t next_sibling; // Node index, T9_DICT_NONE if last
+    uint32_t first_word;   // 1-based word index of the best exact match, 0 if none
+    uint32_t best_word;    // 1-based word index of the best word in this subtree
+    uint8_t digit;         // Digit of the edge leading to this node (2..9)
+} t9_dict_node_t;
+
+/*
+ * Packed dictionary (lv_keyboard_t9_dict_open), generated by tools/t9_dict_gen.py and read in place.
+ * Little-endian uint32 fields, every section 4-byte aligned:
+ *  - header: "T9D" + version byte, then node count, word count, string pool size, byte offsets of
+ *    the node, word and string sections, total size
+ *  - nodes: T9_DICT_PACKED_NODE_WORDS words per node in breadth-first order, node 0 is the root and
+ *    the children of a node are consecutive, sorted by digit:
+ *    [first child | child digit mask << 24][first exact word | exact word count << 24][best string]
+ *    bit d - 2 of the mask is set if digit d has a child, the child index is the first child plus
+ *    the set bits below it. The words of a node are consecutive in the word table and ranked; best
+ *    string is the best word of the subtree, T9_DICT_PACKED_NO_WORD for the root.
+ *  - words: string pool offset of every word
+ *  - strings: NUL terminated words, a word that ends another one points into it
+ */
+#define T9_DICT_PACKED_VERSION 1
+#define T9_DICT_PACKED_HEADER_SIZE 32
+#define T9_DICT_PACKED_NODE_WORDS 3
+#define T9_DICT_PACKED_INDEX_MASK 0x00FFFFFFu
+#define T9_DICT_PACKED_NO_WORD 0xFFFFFFFFu
+
+struct _t9_dict_t
+{
+    t9_dict_node_t *nodes;
+    uint32_t node_count;
+    const char *const *words; // Caller owned, must outlive the dictionary
+    uint16_t *rank;           // Per word rank, higher is better
+    uint32_t *word_next;      // 1-based next word with the same digit sequence, 0 = end
+    uint32_t word_count;
+
+    // Packed dictionary read in place, packed_nodes is NULL for a built one
+    const uint32_t *packed_nodes;
+    const uint32_t *packed_words;
+    const char *packed_strings;
+    uint32_t packed_string_size;
+    const void *map_addr; // Mapping owned by the dictionary (lv_keyboard_t9_dict_open_partition / _file), or NULL
+    uint32_t map_size;
+    uint32_t map_handle;
+};
+
+// Buttonmatrix definitions
+#define T9_BUTTON_COUNT 10 // T9 keys, '1'..'9' and '0'
+
+/*
+ * Keyboard layouts. A layout lists its rows from the top as ROW(X, row, keys...), the keys from the
+ * left by their lv_keyboard_t9_key_t name without the prefix, at most T9_LAYOUT_MAX_COLS per row.
+ * The buttons of a row share its width. A key can be left out, but appear only once (a duplicate
+ * does not compile). X is passed back to the ROW expanders of lv_keyboard_t9_layout.c, which turn
+ * each layout into const tables (btn_id -> key, key -> btn_id, grid cell, map of every mode).
+ */
+#define T9_LAYOUT_MAX_COLS 6
+
+// 4x4 grid, T9 keys on the left and helpers in the last column and row (lv_keyboard_t9_layout_4x4)
+#define T9_LAYOUT_4X4(ROW, X)              \
+    ROW(X, 0, 1, 2, 3, BACKSPACE)          \
+    ROW(X, 1, 4, 5, 6, OK)                 \
+    ROW(X, 2, 7, 8, 9, CLOSE)              \
+    ROW(X, 3, CASE, 0, SPACE, MODE)
+
+// 3x4 phone keypad, case and mode on '*' and '#', helpers in a fifth row (lv_keyboard_t9_layout_phone)
+#define T9_LAYOUT_PHONE(ROW, X)            \
+    ROW(X, 0, 1, 2, 3)                     \
+    ROW(X, 1, 4, 5, 6)                     \
+    ROW(X, 2, 7, 8, 9)                     \
+    ROW(X, 3, CASE, 0, MODE)               \
+    ROW(X, 4, BACKSPACE, SPACE, OK, CLOSE)
+
+// 5 columns with a one-shot shift key (lv_keyboard_t9_layout_5col)
+#define T9_LAYOUT_5COL(ROW, X)             \
+    ROW(X, 0, 1, 2, 3, BACKSPACE, CLOSE)   \
+    ROW(X, 1, 4, 5, 6, SHIFT, OK)          \
+    ROW(X, 2, 7, 8, 9, CASE, MODE)         \
+    ROW(X, 3, 0, SPACE)
+
+#define T9_NARGS(...) T9_NARGS_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define T9_NARGS_(a1, a2, a3, a4, a5, a6, n, ...) n
+// Map entries of a layout: the buttons, a newline after every row but the last and NULL
+#define T9_LAYOUT_MAP_ROW(X, row, ...) T9_NARGS(__VA_ARGS__) + 1 +
+#define T9_LAYOUT_MAP_SIZE(layout) (layout(T9_LAYOUT_MAP_ROW, _) 0)
+#define T9_MAP_SIZE \
+    LV_MAX(T9_LAYOUT_MAP_SIZE(T9_LAYOUT_4X4), LV_MAX(T9_LAYOUT_MAP_SIZE(T9_LAYOUT_PHONE), T9_LAYOUT_MAP_SIZE(T9_LAYOUT_5COL)))
+
+// Grid cell of a button, for invalidating it alone
+typedef struct
+{
+    uint8_t row;
+    uint8_t col;
+    uint8_t cols; // Buttons of the row
+} t9_layout_cell_t;
+
+struct _t9_layout_t
+{
+    const char *const *maps[T9_MODE_PREDICTIVE + 1]; // Buttonmatrix map of every t9_mode_t, same shape
+    const uint8_t *keys;                             // lv_keyboard_t9_key_t of every btn_id
+    const t9_layout_cell_t *cells;                   // Grid cell of every btn_id
+    uint8_t btn_ids[LV_KEYBOARD_T9_KEY_COUNT];       // btn_id + 1 of every key, 0 if not in the layout
+    uint8_t btn_cnt;
+    uint8_t row_cnt;
+};
+
+// Predictive mode
+#ifndef T9_PRED_MAX_DEPTH
+#define T9_PRED_MAX_DEPTH 32 // Longest word that can be composed
+#endif
+#ifndef T9_PRED_CANDIDATES
+#define T9_PRED_CANDIDATES 4 // Candidates shown in the bar
+#endif
+#define T9_PRED_BAR_PCT 20 // Height of the candidate bar, percent of the keyboard parent
+
+// Paged popover: keys with more chars show them one fixed grid page at a time, with a navigation row
+#ifndef T9_POPOVER_PAGE_THRESHOLD
+#define T9_POPOVER_PAGE_THRESHOLD 20 // Longest set shown in one popover (the prebuilt charset map)
+#endif
+#define T9_POPOVER_PAGE_COLS 4
+#define T9_POPOVER_PAGE_ROWS 4
+#define T9_POPOVER_PAGE_CELLS (T9_POPOVER_PAGE_COLS * T9_POPOVER_PAGE_ROWS)
+#define T9_POPOVER_PAGE_BTNS (T9_POPOVER_PAGE_CELLS + 3) // Cells, then previous / page number / next
+#define T9_POPOVER_PAGE_MAP_SIZE (T9_POPOVER_PAGE_BTNS + T9_POPOVER_PAGE_ROWS + 1) // Line breaks and the end marker
+
+// Backspace acceleration (lv_keyboard_t9_set_backspace_accel)
+#ifndef T9_BACKSPACE_WORD_MS
+#define T9_BACKSPACE_WORD_MS 1500 // Hold time before a repeat deletes a word, 0 for chars only
+#endif
+#ifndef T9_BACKSPACE_CLEAR_MS
+#define T9_BACKSPACE_CLEAR_MS 0 // Hold time before the textarea is cleared, 0 for never
+#endif
+#ifndef T9_BACKSPACE_GAP_MS
+#define T9_BACKSPACE_GAP_MS 600 // Longest interval between two backspaces of a hold (the long-press delay)
+#endif
+
+// Bytes of lv_keyboard_t9_insert_text copied on the stack to be NUL terminated, longer texts use lv_malloc
+// (not with a reserved text buffer, the text is then inserted in place)
+#ifndef T9_INSERT_STACK_SIZE
+#define T9_INSERT_STACK_SIZE 64
+#endif
+
+// Popover objects kept per keyboard, each one is reused for the maps with the same button count
+#ifndef T9_POPOVER_CACHE_SIZE
+#if LV_KEYBOARD_T9_PROFILE_MINIMAL
+#define T9_POPOVER_CACHE_SIZE 1
+#else
+#define T9_POPOVER_CACHE_SIZE 4
+#endif
+#endif
+#if T9_POPOVER_CACHE_SIZE > 16
+#error "T9_POPOVER_CACHE_SIZE must be 16 or less"
+#endif
+
+// Keypad long-press detection, same defaults as the LVGL input devices
+#ifndef T9_KEYPAD_LONG_PRESS_MS
+#define T9_KEYPAD_LONG_PRESS_MS 400
+#endif
+#ifndef T9_KEYPAD_REPEAT_MS
+#define T9_KEYPAD_REPEAT_MS 100 // Backspace repeat period once long-pressed
+#endif
+
+// Asynchronous candidate ranking (LV_KEYBOARD_T9_USE_ASYNC_RANK)
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK && !LV_KEYBOARD_T9_USE_PREDICTIVE
+#error "LV_KEYBOARD_T9_USE_ASYNC_RANK needs LV_KEYBOARD_T9_USE_PREDICTIVE"
+#endif
+#ifndef T9_RANK_QUEUE_DEPTH
+#define T9_RANK_QUEUE_DEPTH 4 // Requests in flight (power of 2), past that a press ranks synchronously
+#endif
+#ifndef T9_RANK_TASK_STACK
+#define T9_RANK_TASK_STACK 3072 // FreeRTOS worker stack
+#endif
+#ifndef T9_RANK_TASK_PRIO
+#define T9_RANK_TASK_PRIO 1 // FreeRTOS worker priority, below the LVGL task
+#endif
+
+// Command queue (LV_KEYBOARD_T9_USE_CMD_QUEUE)
+#ifndef T9_CMD_QUEUE_DEPTH
+#define T9_CMD_QUEUE_DEPTH 16 // Slots shared by all keyboards (power of 2), a drain runs at most this many
+#endif
+#ifndef T9_CMD_TEXT_MAX
+#define T9_CMD_TEXT_MAX 16 // Bytes of text per slot, longer texts take consecutive slots
+#endif
+#if T9_CMD_TEXT_MAX < 4 || T9_CMD_TEXT_MAX > 255
+#error "T9_CMD_TEXT_MAX must hold a UTF-8 char and fit a uint8_t"
+#endif
+#ifndef T9_CMD_PERIOD_MS
+#ifdef LV_DEF_REFR_PERIOD
+#define T9_CMD_PERIOD_MS LV_DEF_REFR_PERIOD // Drained once per display refresh
+#else
+#define T9_CMD_PERIOD_MS 33
+#endif
+#endif
+
+// Cached idle key images (LV_KEYBOARD_T9_USE_KEY_CACHE)
+#if LV_KEYBOARD_T9_USE_KEY_CACHE && !LV_USE_SNAPSHOT
+#error "LV_KEYBOARD_T9_USE_KEY_CACHE needs LV_USE_SNAPSHOT in lv_conf.h"
+#endif
+#ifndef T9_KEY_CACHE_SLOTS
+#define T9_KEY_CACHE_SLOTS 2 // Images kept per keyboard, one per mode and matrix size (e.g. lower and upper case)
+#endif
+#if T9_KEY_CACHE_SLOTS < 1 || T9_KEY_CACHE_SLOTS > 8
+#error "T9_KEY_CACHE_SLOTS must be 1..8"
+#endif
+#ifndef T9_KEY_CACHE_CF
+#define T9_KEY_CACHE_CF LV_COLOR_FORMAT_NATIVE_WITH_ALPHA // NATIVE saves the alpha byte if the matrix has square opaque corners
+#endif
+#ifndef T9_KEY_CACHE_DELAY_MS
+#define T9_KEY_CACHE_DELAY_MS 100 // Wait before rendering a missing image, retried until no key is pressed
+#endif
+
+// Microsecond clock of the handler statistics, by default it has the lv_tick resolution
+#ifndef LV_KEYBOARD_T9_TIME_US
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#define LV_KEYBOARD_T9_TIME_US() ((uint32_t)esp_timer_get_time())
+#else
+#define LV_KEYBOARD_T9_TIME_US() (lv_tick_get() * 1000u)
+#endif
+#endif
+
+// Allocation audit (LV_KEYBOARD_T9_USE_ALLOC_AUDIT)
+#ifndef T9_ALLOC_AUDIT_ASSERT
+#define T9_ALLOC_AUDIT_ASSERT 0 // LV_ASSERT on an allocation inside a handler of a warmed keyboard, else only LV_LOG_WARN
+#endif
+
+// Allocation audit of a handler run, removed when LV_KEYBOARD_T9_USE_ALLOC_AUDIT is 0
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+#define T9_AUDIT_BEGIN(kb) t9_alloc_mark_t t9_alloc_mark = t9_alloc_audit_begin(kb)
+#define T9_AUDIT_END(kb, id) t9_alloc_audit_end((kb), (id), t9_alloc_mark)
+#else
+#define T9_AUDIT_BEGIN(kb) do { } while (0)
+#define T9_AUDIT_END(kb, id) do { } while (0)
+#endif
+
+// Statistics and trace helpers, all removed when LV_KEYBOARD_T9_USE_STATS is 0 and no trace hook is set
+#if LV_KEYBOARD_T9_USE_STATS
+#define T9_STAT_INC(kb, field) ((kb)->stats.field++)
+#define T9_HANDLER_BEGIN(kb, id) \
+    uint32_t t9_handler_t0 = LV_KEYBOARD_T9_TIME_US(); \
+    T9_AUDIT_BEGIN(kb); \
+    LV_KEYBOARD_T9_TRACE_BEGIN(id)
+#define T9_HANDLER_END(kb, id) \
+    do { \
+        LV_KEYBOARD_T9_TRACE_END(id); \
+        T9_AUDIT_END((kb), (id)); \
+        t9_stats_handler_done((kb), LV_KEYBOARD_T9_TIME_US() - t9_handler_t0); \
+    } while (0)
+#else
+#define T9_STAT_INC(kb, field) do { } while (0)
+#define T9_HANDLER_BEGIN(kb, id) \
+    T9_AUDIT_BEGIN(kb); \
+    LV_KEYBOARD_T9_TRACE_BEGIN(id)
+#define T9_HANDLER_END(kb, id) \
+    do { \
+        LV_KEYBOARD_T9_TRACE_END(id); \
+        T9_AUDIT_END((kb), (id)); \
+    } while (0)
+#endif
+#define T9_TRACE_BEGIN(id) LV_KEYBOARD_T9_TRACE_BEGIN(id)
+#define T9_TRACE_END(id) LV_KEYBOARD_T9_TRACE_END(id)
+
+// Learned words
+#ifndef T9_LEARN_BATCH
+#define T9_LEARN_BATCH 128 // Bytes of log records buffered before an append
+#endif
+#ifndef T9_LEARN_FLUSH_MS
+#define T9_LEARN_FLUSH_MS 5000 // Idle time before the buffered records are appended
+#endif
+#define T9_LEARN_MIN_LEN 2 // Shorter words are not learned
+
+typedef struct
+{
+    uint16_t count; // Confirmations, 0 = free entry
+    uint8_t len;
+    char word[T9_PRED_MAX_DEPTH + 1]; // Lower case
+} t9_learn_entry_t;
+
+struct _t9_learn_t
+{
+    t9_learn_entry_t *entries;
+    uint32_t entry_max; // From the memory budget
+    uint32_t entry_cnt;
+    lv_keyboard_t9_learn_io_t io;
+    bool has_io;
+    uint32_t log_end; // Bytes used in the log, 0 if it has no header yet
+    lv_timer_t *flush_timer;
+    uint32_t pending_len;
+    uint8_t pending[T9_LEARN_BATCH]; // Records not appended yet
+};
+
+// Shared keyboard
+#define T9_SHARED_TA_GROW 4 // Textarea slots added when the list is full
+
+struct _t9_shared_t
+{
+    lv_obj_t *parent;
+    lv_obj_t *keyboard; // NULL until the first focus or lv_keyboard_t9_prewarm
+    lv_keyboard_t9_shared_init_cb_t init_cb;
+    void *user_data;
+    lv_obj_t **tas; // Registered textareas, their event callbacks point to this state
+    uint32_t ta_cnt;
+    uint32_t ta_cap;
+};
+
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+// Idle key image of one mode, used while the matrix keeps the size it was rendered at
+typedef struct
+{
+    lv_draw_buf_t *buf; // Snapshot of the matrix grown by ext on each side, NULL if the slot is free
+    int32_t w;
+    int32_t h;
+    int32_t ext;
+    uint8_t mode;
+    bool valid; // Cleared when the look of the keys changes, buf is kept to render again
+} t9_key_cache_slot_t;
+#endif
+
+/**
+ * Per keyboard state, a single allocation stored as user data of the keyboard buttonmatrix
+ * and freed on LV_EVENT_DELETE. The charset packs and maps are shared ROM data.
+ */
+typedef struct _t9_keyboard_t
+{
+    lv_obj_t *btnmatrix;
+    lv_obj_t *popover; // Open popover, NULL if none
+    lv_obj_t *popovers[T9_POPOVER_CACHE_SIZE];
+    uint16_t popover_btn_cnt[T9_POPOVER_CACHE_SIZE]; // Buttons of the map set on each popover
+    uint8_t popover_victim;                          // Next slot to re-map when no count matches
+    uint16_t popover_paged;                          // Slots showing pages, bit per slot (hidden cells)
+    lv_obj_t *ta;
+    lv_keyboard_t9_event_cb_t event_cb;
+    const t9_layout_t *layout;
+    const char *map[T9_MAP_SIZE]; // Map given to btnmatrix, entries point into the ROM maps of the layout
+    const lv_keyboard_t9_theme_t *theme;
+
+    // Paged popover, page_count is 0 when the open popover (if any) is not paged
+    const char *page_map[T9_POPOVER_PAGE_MAP_SIZE]; // Entries point into the charset blob
+    char page_label[8];                              // "page/count" of the middle navigation button
+    uint16_t page_first;                             // offs index of the first char of the key
+    uint16_t page_chars;                             // Chars of the key
+    uint8_t page;
+    uint8_t page_count;
+
+    // Multi-tap state: mode, shift, cycling and adaptive timeout (charset in core.charset)
+    t9_core_t core;
+
+    // Backspace hold, from its first press until the key is released or another key is pressed
+    uint32_t bs_start;    // Time of the first backspace of the hold
+    uint32_t bs_last;     // Time of the last one
+    uint16_t bs_word_ms;  // Hold time before deleting words, 0 for chars only
+    uint16_t bs_clear_ms; // Hold time before clearing the textarea, 0 for never
+    bool bs_held;
+
+    // Text buffer of the linked textarea (lv_keyboard_t9_reserve_text), its label shows it as static text
+    char *text_buf;     // NULL if not reserved
+    uint32_t text_cap;  // Bytes, the NUL included
+    uint32_t text_len;  // Bytes, valid while the label shows text_buf
+    lv_obj_t *text_ta;  // Textarea whose LVGL edits release the buffer (t9_text_attach), NULL if none
+
+    // Composition buffer, the char being cycled stays here until committed to the textarea
+    lv_obj_t *preedit;
+    lv_timer_t *commit_timer;
+    char pending[5]; // One UTF-8 char, empty if nothing pending
+    bool compose;
+
+#if LV_KEYBOARD_T9_USE_KEYPAD
+    // Physical keypad (lv_keyboard_t9_feed_key)
+    lv_indev_t *keypad;
+    lv_keyboard_t9_keypad_read_cb_t keypad_read_cb;
+    lv_timer_t *keypad_timer; // Sends the READY/CANCEL of a keypad press once the read callback returned
+    int8_t keypad_event;      // Latched lv_keyboard_t9_event_t, -1 if none
+    bool keypad_reading;      // Inside the read callback of the keypad device
+    uint32_t key_down_time;
+    uint32_t key_repeat_time;
+    int8_t key_down; // lv_keyboard_t9_key_t held, -1 if none
+    bool key_long_done;
+    bool key_focused; // Matrix put in focus-key state to show the held key
+#endif
+
+#if LV_KEYBOARD_T9_USE_INPUT_TRACE
+    // Input recording (lv_keyboard_t9_record_start), rec_buf is NULL when not recording
+    uint8_t *rec_buf;
+    uint32_t rec_size;
+    uint32_t rec_len;
+    uint32_t rec_time; // Time of the last record
+#endif
+
+#if LV_KEYBOARD_T9_USE_CMD_QUEUE
+    // Commands of other tasks (lv_keyboard_t9_post_*), coalesced until the end of a drain
+    struct _t9_keyboard_t *cmd_next; // Keyboards the commands can address
+    lv_obj_t *cmd_ta;                // Last textarea posted, NULL if none
+    int8_t cmd_mode;                 // Last mode posted, -1 if none
+    unsigned cmd_since;              // Ring position at creation, earlier ones were posted to a deleted keyboard
+#endif
+
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+    // Idle key images drawn under the matrix, whose idle keys are then transparent
+    t9_key_cache_slot_t key_cache[T9_KEY_CACHE_SLOTS];
+    lv_timer_t *key_cache_timer; // Renders the missing image of the mode, paused when there is one
+    int8_t key_cache_slot;       // Slot drawn, -1 while the matrix draws all its keys
+    uint8_t key_cache_victim;    // Next slot to reuse when none is free
+#endif
+
+#if LV_KEYBOARD_T9_USE_DIRTY_REPORT
+    lv_keyboard_t9_dirty_t dirty; // Invalidations since the start of the last operation
+#endif
+
+#if LV_KEYBOARD_T9_USE_STATS
+    lv_keyboard_t9_stats_t stats;
+    uint64_t handler_total_us;
+#endif
+
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+    lv_keyboard_t9_alloc_audit_t alloc_audit;
+    uint8_t alloc_depth; // Handlers of this keyboard running, only the outermost one is charged
+#endif
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+    // Predictive mode
+    const t9_dict_t *dict;
+    t9_learn_t *learn;
+    uint32_t learn_mark;      // Bytes of the textarea text learned by the last OK, 0 after a relink
+    uint32_t learn_mark_hash; // Of those bytes, the text was replaced if they changed
+    lv_obj_t *pred_bar;
+    uint32_t pred_path[T9_PRED_MAX_DEPTH + 1]; // Trie cursor, node reached after each matched digit
+    uint8_t pred_digits[T9_PRED_MAX_DEPTH];     // Digits typed for the word being composed
+    uint8_t pred_len;                           // Typed digits, also the composed chars in the textarea
+    uint8_t pred_matched;                       // Leading digits that are still inside the trie
+    uint8_t pred_candidate_count;
+    uint8_t pred_bar_cnt;                                // Candidate slots shown on the bar, the others are hidden
+    const char *pred_candidates[T9_PRED_CANDIDATES + 1]; // Also the candidate bar map, always T9_PRED_CANDIDATES buttons
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+    struct _t9_keyboard_t *rank_next;                           // Keyboards receiving ranking results
+    uint32_t rank_seq;                                          // Request whose result is awaited, 0 if none
+    char pred_text[T9_PRED_MAX_DEPTH + 1];                      // Composed chars in the textarea
+    char pred_words[T9_PRED_CANDIDATES][T9_PRED_MAX_DEPTH + 1]; // Ranked candidates, copied from the worker
+#endif
+#endif // LV_KEYBOARD_T9_USE_PREDICTIVE
+} t9_keyboard_t;
+
+// Link the keyboard with ta, NULL unlinks it (lv_keyboard_t9_set_textarea, the shared keyboard)
+void t9_set_textarea(t9_keyboard_t *kb, lv_obj_t *ta);
+
+// In place edits of the reserved text buffer (lv_keyboard_t9_text.c), false if the caller has to
+// edit the textarea through LVGL (not reserved, password mode, filters, full buffer...)
+bool t9_text_insert(t9_keyboard_t *kb, const char *pre, const char *txt, size_t n);
+bool t9_text_delete(t9_keyboard_t *kb, uint32_t cnt);
+bool t9_text_replace_char(t9_keyboard_t *kb, const char *txt);
+bool t9_text_clear(t9_keyboard_t *kb);
+bool t9_text_adopt(t9_keyboard_t *kb);
+void t9_text_attach(t9_keyboard_t *kb);
+void t9_text_detach(t9_keyboard_t *kb);
+
+#if LV_KEYBOARD_T9_USE_ALLOC_AUDIT
+// Allocations reported by lv_keyboard_t9_alloc_audit_hook when a handler started
+typedef struct
+{
+    uint32_t cnt;
+    uint32_t bytes;
+} t9_alloc_mark_t;
+
+t9_alloc_mark_t t9_alloc_audit_begin(t9_keyboard_t *kb);
+void t9_alloc_audit_end(t9_keyboard_t *kb, lv_keyboard_t9_trace_t id, t9_alloc_mark_t mark);
+#endif
+
+#if LV_KEYBOARD_T9_USE_PREDICTIVE
+int t9_dict_letter_digit(char c);
+uint32_t t9_dict_child(const t9_dict_t *dict, uint32_t node, uint8_t digit);
+const char *t9_dict_get_best(const t9_dict_t *dict, uint32_t node);
+uint32_t t9_dict_get_candidates(const t9_dict_t *dict, uint32_t node, const char **out, uint32_t max);
+void t9_dict_unmap(t9_dict_t *dict);
+
+uint32_t t9_learn_get_candidates(const t9_learn_t *learn, const uint8_t *digits, uint8_t len, const char **out,
+                                 uint32_t max);
+
+uint32_t t9_pred_rank(const t9_dict_t *dict, uint32_t node, bool exact, const t9_learn_t *learn,
+                      const uint8_t *digits, uint8_t len, const char **out);
+#endif // LV_KEYBOARD_T9_USE_PREDICTIVE
+
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+void t9_pred_rank_done(t9_keyboard_t *kb, char (*words)[T9_PRED_MAX_DEPTH + 1], uint8_t count);
+bool t9_rank_attach(t9_keyboard_t *kb);
+void t9_rank_detach(t9_keyboard_t *kb);
+bool t9_rank_post(t9_keyboard_t *kb);
+void t9_rank_sync(void);
+#else
+#define t9_rank_sync() do { } while (0)
+#endif
+
+#if LV_KEYBOARD_T9_USE_INPUT_TRACE
+void t9_input_record(t9_keyboard_t *kb, lv_keyboard_t9_input_t input, uint32_t btn_id, uint32_t now);
+void t9_input_apply(t9_keyboard_t *kb, lv_keyboard_t9_input_t input, uint32_t btn_id, uint32_t now);
+#else
+#define t9_input_record(kb, input, btn_id, now) LV_UNUSED(now)
+#endif
+
+#if LV_KEYBOARD_T9_USE_CMD_QUEUE
+void t9_cmd_attach(t9_keyboard_t *kb);
+void t9_cmd_detach(t9_keyboard_t *kb);
+#endif
+
+#if LV_KEYBOARD_T9_USE_KEY_CACHE
+void t9_key_cache_attach(t9_keyboard_t *kb);
+void t9_key_cache_detach(t9_keyboard_t *kb);
+void t9_key_cache_sync(t9_keyboard_t *kb);
+void t9_key_cache_invalidate(t9_keyboard_t *kb);
+#else
+#define t9_key_cache_sync(kb) do { } while (0)
+#define t9_key_cache_invalidate(kb) do { } while (0)
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LV_KEYBOARD_T9_PRIVATE_H
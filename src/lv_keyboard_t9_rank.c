@@ -0,0 +1,306 @@
+/**
+ * @file lv_keyboard_t9_rank.c
+ * @brief Asynchronous predictive candidate ranking of the T9 keyboard (LV_KEYBOARD_T9_USE_ASYNC_RANK).
+ *
+ * The press handler only walks the trie and posts the typed sequence to a worker, a FreeRTOS task on
+ * ESP-IDF or a pthread elsewhere, shared by all keyboards. Requests and results travel in two
+ * single-producer / single-consumer rings, so neither side ever waits for the other:
+ *  - requests: written by the LVGL thread, read by the worker
+ *  - results: written by the worker, read on the LVGL thread from an lv_async_call callback
+ *
+ * Every request gets a new sequence number and a keyboard only applies the result of its last one,
+ * results of older sequences (the user kept typing) are dropped. At most T9_RANK_QUEUE_DEPTH
+ * requests are in flight, past that the press ranks synchronously as without this option.
+ *
+ * The worker reads the dictionaries and the learned words, so the functions deleting or changing
+ * them call t9_rank_sync() first: queued requests are invalidated and the running one is waited for.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+#if LV_KEYBOARD_T9_USE_ASYNC_RANK
+
+#include <stdatomic.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Taken by the worker around lv_async_call, the only LVGL call it makes
+#ifndef LV_KEYBOARD_T9_RANK_LOCK
+#if LV_USE_OS == LV_OS_NONE
+#error "LV_KEYBOARD_T9_USE_ASYNC_RANK needs LV_USE_OS or a LV_KEYBOARD_T9_RANK_LOCK/UNLOCK of the application"
+#endif
+#define LV_KEYBOARD_T9_RANK_LOCK() lv_lock()
+#define LV_KEYBOARD_T9_RANK_UNLOCK() lv_unlock()
+#endif
+
+#if (T9_RANK_QUEUE_DEPTH & (T9_RANK_QUEUE_DEPTH - 1)) != 0
+#error "T9_RANK_QUEUE_DEPTH must be a power of 2"
+#endif
+
+typedef struct
+{
+    t9_keyboard_t *kb; // Only compared on the LVGL thread, never dereferenced by the worker
+    uint32_t seq;
+    uint32_t epoch; // t9_rank_epoch when posted, the dictionary and learned words are valid while it matches
+    const t9_dict_t *dict;
+    const t9_learn_t *learn;
+    uint32_t node;
+    uint8_t digits[T9_PRED_MAX_DEPTH];
+    uint8_t len;
+    bool exact;
+} t9_rank_req_t;
+
+typedef struct
+{
+    t9_keyboard_t *kb;
+    uint32_t seq;
+    bool valid;
+    uint8_t count;
+    char words[T9_PRED_CANDIDATES][T9_PRED_MAX_DEPTH + 1]; // Copied, the worker may rank again meanwhile
+} t9_rank_res_t;
+
+// Free running indexes, the slot is index % T9_RANK_QUEUE_DEPTH
+typedef struct
+{
+    atomic_uint head; // Written by the producer only
+    atomic_uint tail; // Written by the consumer only
+} t9_rank_ring_t;
+
+static t9_rank_req_t t9_rank_reqs[T9_RANK_QUEUE_DEPTH];
+static t9_rank_ring_t t9_rank_req_ring;
+static t9_rank_res_t t9_rank_results[T9_RANK_QUEUE_DEPTH];
+static t9_rank_ring_t t9_rank_res_ring;
+
+static atomic_uint t9_rank_epoch;
+static atomic_bool t9_rank_busy;         // The worker is ranking a request
+static atomic_bool t9_rank_kick_pending; // An lv_async_call is scheduled and has not started draining
+
+// LVGL thread only
+static t9_keyboard_t *t9_rank_clients; // Keyboards that may receive results
+static uint32_t t9_rank_seq;
+static uint32_t t9_rank_inflight; // Posted requests whose result has not been drained
+static bool t9_rank_started;
+
+#if defined(ESP_PLATFORM)
+static TaskHandle_t t9_rank_task;
+#else
+static pthread_t t9_rank_thread;
+static pthread_mutex_t t9_rank_wake_mutex = PTHREAD_MUTEX_INITIALIZER; // Sleep only, not the rings
+static pthread_cond_t t9_rank_wake_cond = PTHREAD_COND_INITIALIZER;
+static bool t9_rank_wake;
+#endif
+
+// --- Worker ---
+
+static void t9_rank_async_cb(void *user_data);
+
+// Let the LVGL thread drain the results, one scheduled callback at a time
+static void t9_rank_kick(void)
+{
+    if (atomic_exchange(&t9_rank_kick_pending, true))
+        return;
+    LV_KEYBOARD_T9_RANK_LOCK();
+    lv_result_t res = lv_async_call(t9_rank_async_cb, NULL);
+    LV_KEYBOARD_T9_RANK_UNLOCK();
+    if (res != LV_RESULT_OK)
+        atomic_store(&t9_rank_kick_pending, false); // Retried with the next result
+}
+
+// Rank every queued request. The result ring can not be full: it holds at most the results of
+// the requests in flight.
+static void t9_rank_work(void)
+{
+    for (;;)
+    {
+        unsigned t = atomic_load_explicit(&t9_rank_req_ring.tail, memory_order_relaxed);
+        if (t == atomic_load_explicit(&t9_rank_req_ring.head, memory_order_acquire))
+            return;
+        const t9_rank_req_t *req = &t9_rank_reqs[t % T9_RANK_QUEUE_DEPTH];
+        unsigned h = atomic_load_explicit(&t9_rank_res_ring.head, memory_order_relaxed);
+        t9_rank_res_t *res = &t9_rank_results[h % T9_RANK_QUEUE_DEPTH];
+
+        // Busy before the epoch check, pairs with t9_rank_sync (both sequentially consistent)
+        atomic_store(&t9_rank_busy, true);
+        res->kb = req->kb;
+        res->seq = req->seq;
+        res->count = 0;
+        res->valid = atomic_load(&t9_rank_epoch) == req->epoch;
+        if (res->valid)
+        {
+            const char *words[T9_PRED_CANDIDATES];
+            uint32_t cnt = t9_pred_rank(req->dict, req->node, req->exact, req->learn, req->digits, req->len, words);
+            for (uint32_t i = 0; i < cnt; i++)
+                lv_strncpy(res->words[i], words[i], sizeof(res->words[i])); // Terminated, like strlcpy
+            res->count = (uint8_t)cnt;
+        }
+        atomic_store(&t9_rank_busy, false);
+
+        atomic_store_explicit(&t9_rank_req_ring.tail, t + 1, memory_order_release);
+        atomic_store_explicit(&t9_rank_res_ring.head, h + 1, memory_order_release);
+        t9_rank_kick();
+    }
+}
+
+#if defined(ESP_PLATFORM)
+static void t9_rank_task_fn(void *arg)
+{
+    LV_UNUSED(arg);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        t9_rank_work();
+    }
+}
+#else
+static void *t9_rank_thread_fn(void *arg)
+{
+    LV_UNUSED(arg);
+    for (;;)
+    {
+        pthread_mutex_lock(&t9_rank_wake_mutex);
+        while (!t9_rank_wake)
+            pthread_cond_wait(&t9_rank_wake_cond, &t9_rank_wake_mutex);
+        t9_rank_wake = false;
+        pthread_mutex_unlock(&t9_rank_wake_mutex);
+        t9_rank_work();
+    }
+    return NULL;
+}
+#endif
+
+static bool t9_rank_start(void)
+{
+#if defined(ESP_PLATFORM)
+    return xTaskCreate(t9_rank_task_fn, "t9_rank", T9_RANK_TASK_STACK, NULL, T9_RANK_TASK_PRIO, &t9_rank_task) ==
+           pdPASS;
+#else
+    if (pthread_create(&t9_rank_thread, NULL, t9_rank_thread_fn, NULL) != 0)
+        return false;
+    pthread_detach(t9_rank_thread);
+    return true;
+#endif
+}
+
+static void t9_rank_wake_worker(void)
+{
+#if defined(ESP_PLATFORM)
+    xTaskNotifyGive(t9_rank_task);
+#else
+    pthread_mutex_lock(&t9_rank_wake_mutex);
+    t9_rank_wake = true;
+    pthread_cond_signal(&t9_rank_wake_cond);
+    pthread_mutex_unlock(&t9_rank_wake_mutex);
+#endif
+}
+
+// --- LVGL thread ---
+
+// Apply the results of the last request of each keyboard, drop the others
+static void t9_rank_async_cb(void *user_data)
+{
+    LV_UNUSED(user_data);
+    atomic_store(&t9_rank_kick_pending, false); // Before draining, a later result kicks again
+    for (;;)
+    {
+        unsigned t = atomic_load_explicit(&t9_rank_res_ring.tail, memory_order_relaxed);
+        if (t == atomic_load_explicit(&t9_rank_res_ring.head, memory_order_acquire))
+            break;
+        t9_rank_res_t *res = &t9_rank_results[t % T9_RANK_QUEUE_DEPTH];
+        t9_rank_inflight--;
+        t9_keyboard_t *kb = t9_rank_clients;
+        while (kb != NULL && kb != res->kb)
+            kb = kb->rank_next;
+        if (kb != NULL && res->valid && kb->rank_seq == res->seq)
+        {
+            kb->rank_seq = 0;
+            t9_pred_rank_done(kb, res->words, res->count);
+        }
+        atomic_store_explicit(&t9_rank_res_ring.tail, t + 1, memory_order_release);
+    }
+}
+
+/**
+ * Register a new keyboard, starting the worker with the first one.
+ *
+ * @return false if the worker could not be started, the keyboard then ranks synchronously
+ */
+bool t9_rank_attach(t9_keyboard_t *kb)
+{
+    if (!t9_rank_started)
+    {
+        t9_rank_started = t9_rank_start();
+        if (!t9_rank_started)
+            LV_LOG_WARN("t9_rank_attach: could not start the ranking worker");
+    }
+    kb->rank_next = t9_rank_clients;
+    t9_rank_clients = kb;
+    return t9_rank_started;
+}
+
+// Unregister a deleted keyboard, its results still in flight are dropped when drained
+void t9_rank_detach(t9_keyboard_t *kb)
+{
+    t9_keyboard_t **link = &t9_rank_clients;
+    while (*link != NULL && *link != kb)
+        link = &(*link)->rank_next;
+    if (*link != NULL)
+        *link = kb->rank_next;
+}
+
+/**
+ * Post the typed sequence of a keyboard to the worker, t9_pred_rank_done is called with the result
+ * unless the keyboard posts again or resets its rank_seq first.
+ *
+ * @return false if the worker is not running or too many requests are in flight, rank synchronously
+ */
+bool t9_rank_post(t9_keyboard_t *kb)
+{
+    if (!t9_rank_started || t9_rank_inflight == T9_RANK_QUEUE_DEPTH)
+        return false;
+    unsigned h = atomic_load_explicit(&t9_rank_req_ring.head, memory_order_relaxed);
+    t9_rank_req_t *req = &t9_rank_reqs[h % T9_RANK_QUEUE_DEPTH];
+    if (++t9_rank_seq == 0)
+        t9_rank_seq = 1; // 0 means no request
+    req->kb = kb;
+    req->seq = t9_rank_seq;
+    req->epoch = atomic_load(&t9_rank_epoch);
+    req->dict = kb->dict;
+    req->learn = kb->learn;
+    req->node = kb->pred_path[kb->pred_matched];
+    req->exact = kb->pred_matched == kb->pred_len;
+    req->len = kb->pred_len;
+    lv_memcpy(req->digits, kb->pred_digits, kb->pred_len);
+    kb->rank_seq = t9_rank_seq;
+    t9_rank_inflight++;
+    atomic_store_explicit(&t9_rank_req_ring.head, h + 1, memory_order_release);
+    t9_rank_wake_worker();
+    return true;
+}
+
+/**
+ * Make the dictionaries and learned words safe to change or free: the queued requests are
+ * invalidated (their result is empty) and the request being ranked is waited for.
+ */
+void t9_rank_sync(void)
+{
+    if (!t9_rank_started)
+        return;
+    atomic_fetch_add(&t9_rank_epoch, 1);
+    while (atomic_load(&t9_rank_busy))
+    {
+#if defined(ESP_PLATFORM)
+        vTaskDelay(1); // Blocks, the worker usually has a lower priority
+#else
+        sched_yield();
+#endif
+    }
+}
+
+#endif // LV_KEYBOARD_T9_USE_ASYNC_RANK
@@ -0,0 +1,235 @@
+/**
+ * @file lv_keyboard_t9_shared.c
+ * @brief One T9 keyboard shared by many textareas, built on the first focus.
+ *
+ * A screen with several text fields registers them and pays nothing else until one is focused:
+ * the keyboard is then built in the given parent, relinked with lv_keyboard_t9_set_textarea on
+ * every focus change and only hidden on defocus, so later focuses neither build nor allocate.
+ * Only the public keyboard API is used, and t9_set_textarea to unlink a deleted textarea.
+ *
+ * The registered textareas keep a pointer to the shared state in their event callbacks, the
+ * state unregisters them (removing the callbacks) before it is freed with the parent.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+static void t9_shared_ta_event_cb(lv_event_t *e);
+
+static int32_t t9_shared_find(const t9_shared_t *shared, const lv_obj_t *ta)
+{
+    for (uint32_t i = 0; i < shared->ta_cnt; i++)
+    {
+        if (shared->tas[i] == ta)
+            return (int32_t)i;
+    }
+    return -1;
+}
+
+static void t9_shared_show(t9_shared_t *shared, bool show)
+{
+    if (show)
+        lv_obj_remove_flag(shared->parent, LV_OBJ_FLAG_HIDDEN);
+    else
+        lv_obj_add_flag(shared->parent, LV_OBJ_FLAG_HIDDEN);
+}
+
+// The application deleted the keyboard itself, build it again on the next focus
+static void t9_shared_keyboard_delete_cb(lv_event_t *e)
+{
+    t9_shared_t *shared = lv_event_get_user_data(e);
+    shared->keyboard = NULL;
+}
+
+static lv_obj_t *t9_shared_build(t9_shared_t *shared, lv_obj_t *ta)
+{
+    shared->keyboard = lv_keyboard_t9_init(shared->parent, ta);
+    if (shared->keyboard == NULL)
+    {
+        LV_LOG_WARN("t9_shared_build: could not create the keyboard");
+        return NULL;
+    }
+    lv_obj_add_event_cb(shared->keyboard, t9_shared_keyboard_delete_cb, LV_EVENT_DELETE, shared);
+    if (shared->init_cb)
+        shared->init_cb(shared->keyboard, shared->user_data);
+    return shared->keyboard;
+}
+
+static void t9_shared_ta_event_cb(lv_event_t *e)
+{
+    t9_shared_t *shared = lv_event_get_user_data(e);
+    lv_obj_t *ta = lv_event_get_current_target(e);
+
+    switch (lv_event_get_code(e))
+    {
+    case LV_EVENT_FOCUSED:
+        if (shared->keyboard == NULL)
+        {
+            if (t9_shared_build(shared, ta) == NULL)
+                return;
+        }
+        else if (lv_keyboard_t9_get_textarea(shared->keyboard) != ta)
+        {
+            lv_keyboard_t9_set_textarea(shared->keyboard, ta);
+        }
+        t9_shared_show(shared, true);
+        break;
+    case LV_EVENT_DEFOCUSED:
+        // Moving to another registered textarea shows the keyboard again before the next refresh
+        if (shared->keyboard && lv_keyboard_t9_get_textarea(shared->keyboard) == ta)
+            t9_shared_show(shared, false);
+        break;
+    case LV_EVENT_DELETE:
+        lv_keyboard_t9_shared_remove_textarea(shared, ta);
+        break;
+    default:
+        break;
+    }
+}
+
+// Unregister all the textareas and free the state together with the parent
+static void t9_shared_parent_delete_cb(lv_event_t *e)
+{
+    t9_shared_t *shared = lv_event_get_user_data(e);
+    for (uint32_t i = 0; i < shared->ta_cnt; i++)
+        lv_obj_remove_event_cb_with_user_data(shared->tas[i], t9_shared_ta_event_cb, shared);
+    if (shared->keyboard)
+        lv_obj_remove_event_cb_with_user_data(shared->keyboard, t9_shared_keyboard_delete_cb, shared);
+    lv_free(shared->tas);
+    lv_free(shared);
+}
+
+/**
+ * @brief Create a keyboard shared by textareas, built in parent on the first focus.
+ * @param parent Container of the keyboard, hidden while no registered textarea is focused
+ * @param init_cb Called once the keyboard is built to configure it (can be NULL)
+ * @param user_data Given back to init_cb
+ * @return The shared state, freed when parent is deleted, or NULL on error
+ */
+t9_shared_t *lv_keyboard_t9_shared_create(lv_obj_t *parent, lv_keyboard_t9_shared_init_cb_t init_cb,
+                                          void *user_data)
+{
+    if (parent == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_shared_create: parent is NULL");
+        return NULL;
+    }
+    t9_shared_t *shared = lv_malloc_zeroed(sizeof(t9_shared_t));
+    if (shared == NULL)
+        return NULL;
+    shared->parent = parent;
+    shared->init_cb = init_cb;
+    shared->user_data = user_data;
+    lv_obj_add_event_cb(parent, t9_shared_parent_delete_cb, LV_EVENT_DELETE, shared);
+    t9_shared_show(shared, false);
+    return shared;
+}
+
+/**
+ * @brief Register a textarea with the shared keyboard.
+ * @param shared Shared keyboard state
+ * @param ta Textarea linked to the keyboard whenever it is focused
+ */
+void lv_keyboard_t9_shared_add_textarea(t9_shared_t *shared, lv_obj_t *ta)
+{
+    if (shared == NULL || ta == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_shared_add_textarea: shared or ta is NULL");
+        return;
+    }
+    if (t9_shared_find(shared, ta) >= 0)
+        return;
+    if (shared->ta_cnt == shared->ta_cap)
+    {
+        uint32_t cap = shared->ta_cap + T9_SHARED_TA_GROW;
+        lv_obj_t **tas = lv_realloc(shared->tas, cap * sizeof(lv_obj_t *));
+        if (tas == NULL)
+            return;
+        shared->tas = tas;
+        shared->ta_cap = cap;
+    }
+    shared->tas[shared->ta_cnt++] = ta;
+    lv_obj_add_event_cb(ta, t9_shared_ta_event_cb, LV_EVENT_FOCUSED, shared);
+    lv_obj_add_event_cb(ta, t9_shared_ta_event_cb, LV_EVENT_DEFOCUSED, shared);
+    lv_obj_add_event_cb(ta, t9_shared_ta_event_cb, LV_EVENT_DELETE, shared);
+
+    // Registered while already focused, e.g. the first field of a group
+    if (lv_obj_has_state(ta, LV_STATE_FOCUSED))
+        lv_obj_send_event(ta, LV_EVENT_FOCUSED, NULL);
+}
+
+/**
+ * @brief Unregister a textarea from the shared keyboard.
+ * @param shared Shared keyboard state
+ * @param ta Registered textarea
+ */
+void lv_keyboard_t9_shared_remove_textarea(t9_shared_t *shared, lv_obj_t *ta)
+{
+    if (shared == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_shared_remove_textarea: shared is NULL");
+        return;
+    }
+    int32_t idx = t9_shared_find(shared, ta);
+    if (idx < 0)
+        return;
+    lv_obj_remove_event_cb_with_user_data(ta, t9_shared_ta_event_cb, shared);
+    shared->ta_cnt--;
+    shared->tas[idx] = shared->tas[shared->ta_cnt];
+
+    // Flush the pending char into ta (still valid in LV_EVENT_DELETE), then move the keyboard to
+    // another registered textarea or unlink it, hidden until a focus
+    if (shared->keyboard && lv_keyboard_t9_get_textarea(shared->keyboard) == ta)
+    {
+        t9_set_textarea(lv_obj_get_user_data(shared->keyboard), shared->ta_cnt ? shared->tas[0] : NULL);
+        t9_shared_show(shared, false);
+    }
+}
+
+/**
+ * @brief Register the textareas of a group with the shared keyboard.
+ * @param shared Shared keyboard state
+ * @param group Group whose textareas are registered, the other objects are ignored
+ */
+void lv_keyboard_t9_shared_add_group(t9_shared_t *shared, lv_group_t *group)
+{
+    if (shared == NULL || group == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_shared_add_group: shared or group is NULL");
+        return;
+    }
+    uint32_t cnt = lv_group_get_obj_count(group);
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        lv_obj_t *obj = lv_group_get_obj_by_index(group, i);
+        if (lv_obj_check_type(obj, &lv_textarea_class))
+            lv_keyboard_t9_shared_add_textarea(shared, obj);
+    }
+}
+
+/**
+ * @brief Build the shared keyboard ahead of the first focus, e.g. while the screen loads.
+ * @param shared Shared keyboard state
+ * @return The keyboard, or NULL if no textarea is registered
+ */
+lv_obj_t *lv_keyboard_t9_prewarm(t9_shared_t *shared)
+{
+    if (shared == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_prewarm: shared is NULL");
+        return NULL;
+    }
+    if (shared->keyboard)
+        return shared->keyboard;
+    if (shared->ta_cnt == 0)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_prewarm: no textarea registered");
+        return NULL;
+    }
+    return t9_shared_build(shared, shared->tas[0]); // Parent stays hidden until a focus
+}
+
+lv_obj_t *lv_keyboard_t9_shared_get_keyboard(t9_shared_t *shared)
+{
+    return shared ? shared->keyboard : NULL;
+}
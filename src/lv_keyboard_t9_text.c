@@ -0,0 +1,259 @@
+/**
+ * @file lv_keyboard_t9_text.c
+ * @brief Reserved text buffer of the linked textarea (lv_keyboard_t9_reserve_text).
+ *
+ * lv_textarea_add_text and lv_textarea_delete_char realloc the label text on every edit, and even
+ * a refresh of the label with its own text (lv_label_set_text(label, NULL)) goes through lv_realloc.
+ * With a reserved buffer the label shows the text of the keyboard as static text: the keyboard
+ * edits it in place with memmove and refreshes the label with lv_label_set_text_static, which
+ * allocates nothing.
+ *
+ * The buffer is adopted by copying the textarea text into it on the next keyboard edit, and given
+ * back as a dynamic copy of the label (lv_label_set_text) when LVGL itself edits the textarea
+ * (LV_EVENT_INSERT of lv_textarea_add_text / delete_char, the textarea keys), when the textarea is
+ * unlinked or the keyboard deleted. lv_textarea_set_text replaces the label text and so releases it
+ * too. Password mode, accepted chars, a max length or a full buffer use the LVGL edits.
+ * Like the fast paths of lv_keyboard_t9_textarea_replace_char, the in place edits only send
+ * LV_EVENT_VALUE_CHANGED, not LV_EVENT_INSERT.
+ */
+#include "lvgl.h"
+#include "lv_keyboard_t9.h"
+#include "lv_keyboard_t9_private.h"
+
+// The label shows the buffer
+static bool t9_text_adopted(const t9_keyboard_t *kb)
+{
+    return kb->text_buf && kb->ta == kb->text_ta && kb->ta &&
+           lv_label_get_text(lv_textarea_get_label(kb->ta)) == kb->text_buf;
+}
+
+// Give the label a dynamic copy of the buffer, LVGL can then edit it (allocates)
+static void t9_text_release(t9_keyboard_t *kb)
+{
+    if (t9_text_adopted(kb))
+        lv_label_set_text(lv_textarea_get_label(kb->ta), kb->text_buf);
+}
+
+// LVGL is about to edit the textarea (or it is deleted): the label needs its own text again
+static void t9_text_event_cb(lv_event_t *e)
+{
+    t9_keyboard_t *kb = lv_event_get_user_data(e);
+    if (lv_event_get_code(e) == LV_EVENT_DELETE)
+    {
+        kb->text_ta = NULL; // The static text is not freed with the label
+        return;
+    }
+    t9_text_release(kb);
+}
+
+// Watch the LVGL edits of the linked textarea (allocates the event descriptors, on relink only)
+void t9_text_attach(t9_keyboard_t *kb)
+{
+    if (kb->text_buf == NULL || kb->ta == NULL || kb->text_ta == kb->ta)
+        return;
+    t9_text_detach(kb);
+    lv_obj_add_event_cb(kb->ta, t9_text_event_cb, LV_EVENT_INSERT, kb);
+    lv_obj_add_event_cb(kb->ta, t9_text_event_cb, LV_EVENT_DELETE, kb);
+    kb->text_ta = kb->ta;
+}
+
+// Give the text back to the watched textarea and stop watching it
+void t9_text_detach(t9_keyboard_t *kb)
+{
+    if (kb->text_ta == NULL)
+        return;
+    if (kb->ta == kb->text_ta)
+        t9_text_release(kb);
+    else if (lv_label_get_text(lv_textarea_get_label(kb->text_ta)) == kb->text_buf)
+        lv_label_set_text(lv_textarea_get_label(kb->text_ta), kb->text_buf);
+    lv_obj_remove_event_cb_with_user_data(kb->text_ta, t9_text_event_cb, kb);
+    kb->text_ta = NULL;
+}
+
+/**
+ * Make the label of the linked textarea show the buffer, copying its current text. Nothing is
+ * allocated: the dynamic text of the label is freed.
+ * Returns false if the textarea has to be edited through LVGL.
+ */
+bool t9_text_adopt(t9_keyboard_t *kb)
+{
+    if (kb->text_buf == NULL || kb->ta == NULL)
+        return false;
+    if (t9_text_adopted(kb))
+        return true;
+    lv_obj_t *ta = kb->ta;
+    if (lv_textarea_get_password_mode(ta) || lv_textarea_get_accepted_chars(ta) || lv_textarea_get_max_length(ta))
+        return false; // The label shows bullets, or add_text filters the chars
+    if (kb->text_ta != ta)
+        return false; // Not watched (set_textarea attaches), an LVGL edit would not be seen
+    lv_obj_t *label = lv_textarea_get_label(ta);
+    const char *text = lv_label_get_text(label);
+    size_t len = lv_strlen(text);
+    if (len >= kb->text_cap)
+        return false;
+    lv_memcpy(kb->text_buf, text, len + 1);
+    kb->text_len = (uint32_t)len;
+    lv_label_set_text_static(label, kb->text_buf);
+    return true;
+}
+
+/**
+ * Show the edited buffer: relayout of the label, cursor and LV_EVENT_VALUE_CHANGED.
+ *
+ * @param cursor Cursor position after the edit, in chars
+ * @param placeholder The text became empty or stopped being empty
+ */
+static void t9_text_refresh(t9_keyboard_t *kb, uint32_t cursor, bool placeholder)
+{
+    lv_obj_t *ta = kb->ta;
+    lv_label_set_text_static(lv_textarea_get_label(ta), kb->text_buf); // Same buffer, nothing allocated
+    // Move the cursor back and forth if it stays, so its area follows the new glyph width
+    if (cursor > 0 && cursor == lv_textarea_get_cursor_pos(ta))
+        lv_textarea_set_cursor_pos(ta, (int32_t)cursor - 1);
+    lv_textarea_set_cursor_pos(ta, (int32_t)cursor);
+    if (placeholder)
+        lv_obj_invalidate(ta);
+    lv_obj_send_event(ta, LV_EVENT_VALUE_CHANGED, NULL);
+}
+
+// Chars of n bytes of UTF-8 text
+static uint32_t t9_text_char_cnt(const char *txt, size_t n)
+{
+    uint32_t cnt = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (((uint8_t)txt[i] & 0xC0) != 0x80)
+            cnt++;
+    }
+    return cnt;
+}
+
+// A one-line textarea drops newlines, lv_textarea_add_text has to filter them
+static bool t9_text_has_newline(const char *txt, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (txt[i] == '\n' || txt[i] == '\r')
+            return true;
+    }
+    return false;
+}
+
+// Insert pre (NUL terminated, e.g. the pending char) then n bytes of txt (no NUL among them) at the cursor, in one edit
+bool t9_text_insert(t9_keyboard_t *kb, const char *pre, const char *txt, size_t n)
+{
+    if (!t9_text_adopt(kb))
+        return false;
+    size_t pre_n = lv_strlen(pre);
+    if (lv_textarea_get_one_line(kb->ta) && (t9_text_has_newline(pre, pre_n) || t9_text_has_newline(txt, n)))
+        return false;
+    if (kb->text_len + pre_n + n >= kb->text_cap)
+    {
+        LV_LOG_INFO("lv_keyboard_t9: text buffer full, the textarea text is reallocated again");
+        t9_text_release(kb);
+        return false;
+    }
+    char *buf = kb->text_buf;
+    uint32_t pos = lv_textarea_get_cursor_pos(kb->ta);
+    uint32_t at = lv_text_encoded_get_byte_id(buf, pos);
+    bool was_empty = kb->text_len == 0;
+    lv_memmove(&buf[at + pre_n + n], &buf[at], kb->text_len - at + 1);
+    lv_memcpy(&buf[at], pre, pre_n);
+    lv_memcpy(&buf[at + pre_n], txt, n);
+    kb->text_len += (uint32_t)(pre_n + n);
+    t9_text_refresh(kb, pos + t9_text_char_cnt(pre, pre_n) + t9_text_char_cnt(txt, n), was_empty && pre_n + n > 0);
+    return true;
+}
+
+// Delete cnt chars before the cursor, clamped to the cursor position
+bool t9_text_delete(t9_keyboard_t *kb, uint32_t cnt)
+{
+    if (!t9_text_adopt(kb))
+        return false;
+    char *buf = kb->text_buf;
+    uint32_t pos = lv_textarea_get_cursor_pos(kb->ta);
+    if (cnt > pos)
+        cnt = pos;
+    if (cnt == 0)
+        return true;
+    uint32_t start = lv_text_encoded_get_byte_id(buf, pos - cnt);
+    uint32_t end = lv_text_encoded_get_byte_id(buf, pos);
+    lv_memmove(&buf[start], &buf[end], kb->text_len - end + 1);
+    kb->text_len -= end - start;
+    t9_text_refresh(kb, pos - cnt, kb->text_len == 0);
+    return true;
+}
+
+// Replace the char before the cursor with txt (one UTF-8 char), whatever their encoded sizes
+bool t9_text_replace_char(t9_keyboard_t *kb, const char *txt)
+{
+    if (!t9_text_adopt(kb))
+        return false;
+    uint32_t pos = lv_textarea_get_cursor_pos(kb->ta);
+    if (pos == 0)
+        return t9_text_insert(kb, "", txt, lv_strlen(txt)); // Nothing to replace before the cursor
+    char *buf = kb->text_buf;
+    uint32_t start = lv_text_encoded_get_byte_id(buf, pos - 1);
+    uint32_t end = lv_text_encoded_get_byte_id(buf, pos);
+    size_t n = lv_strlen(txt);
+    if (kb->text_len - (end - start) + n >= kb->text_cap)
+    {
+        t9_text_release(kb);
+        return false;
+    }
+    lv_memmove(&buf[start + n], &buf[end], kb->text_len - end + 1);
+    lv_memcpy(&buf[start], txt, n);
+    kb->text_len = kb->text_len - (end - start) + (uint32_t)n;
+    t9_text_refresh(kb, pos, false);
+    return true;
+}
+
+// Empty the textarea
+bool t9_text_clear(t9_keyboard_t *kb)
+{
+    if (!t9_text_adopt(kb))
+        return false;
+    bool was_empty = kb->text_len == 0;
+    kb->text_buf[0] = '\0';
+    kb->text_len = 0;
+    t9_text_refresh(kb, 0, !was_empty);
+    return true;
+}
+
+/**
+ * @brief Edit the text of the linked textareas in a buffer of the keyboard instead of the label text.
+ * Every keyboard edit of a textarea then happens in place, without the lv_realloc of the label text
+ * done by lv_textarea_add_text and lv_textarea_delete_char. The buffer is allocated here, once, and
+ * freed with the keyboard. Texts longer than the buffer, password mode and textareas with accepted
+ * chars or a max length are edited through LVGL as without it.
+ * @param keyboard Pointer to the T9 keyboard object
+ * @param capacity Longest text in bytes plus one, 0 to free the buffer
+ * @return false if the buffer could not be allocated (the keyboard then edits through LVGL)
+ */
+bool lv_keyboard_t9_reserve_text(lv_obj_t *keyboard, uint32_t capacity)
+{
+    t9_keyboard_t *kb = keyboard ? lv_obj_get_user_data(keyboard) : NULL;
+    if (kb == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_reserve_text: keyboard is NULL");
+        return false;
+    }
+    t9_text_detach(kb); // The textarea keeps a copy of the text
+    lv_free(kb->text_buf);
+    kb->text_buf = NULL;
+    kb->text_cap = 0;
+    kb->text_len = 0;
+    if (capacity == 0)
+        return true;
+    kb->text_buf = lv_malloc(capacity);
+    if (kb->text_buf == NULL)
+    {
+        LV_LOG_WARN("lv_keyboard_t9_reserve_text: out of memory");
+        return false;
+    }
+    kb->text_buf[0] = '\0';
+    kb->text_cap = capacity;
+    t9_text_attach(kb);
+    t9_text_adopt(kb);
+    return true;
+}
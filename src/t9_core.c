@@ -0,0 +1,205 @@
+/**
+ * @file t9_core.c
+ * @brief LVGL independent T9 multi-tap engine, see t9_core.h.
+ *
+ * Only the C library headers are used: the state is owned by the caller and the edits point into
+ * the const charset pack, so a press is a few branches and table lookups without any allocation.
+ */
+#include "t9_core.h"
+
+// Adaptive multi-tap timeout (t9_core_set_adaptive_timeout)
+#define T9_ADAPT_SHIFT 3 // EWMA weight of a new interval, 1 / 2^T9_ADAPT_SHIFT
+#ifndef T9_ADAPT_MARGIN_PCT
+#define T9_ADAPT_MARGIN_PCT 200 // Timeout in percent of the average same-key interval
+#endif
+
+#define T9_CORE_CHAR_KEYS 10 // T9_CORE_KEY_1..T9_CORE_KEY_0, the keys of the charset packs
+
+// Numeric mode chars
+static const char *const t9_core_digits[T9_CORE_CHAR_KEYS] = {"1", "2", "3", "4", "5", "6", "7", "8", "9", "0"};
+
+// Write one edit if there is room, the state has changed either way
+static uint32_t t9_core_emit(t9_edit_t *edits, uint32_t max, t9_edit_type_t type, bool open, uint16_t cnt,
+                             const char *text)
+{
+    if (edits == NULL || max == 0)
+        return 0;
+    edits->type = (uint8_t)type;
+    edits->open = open;
+    edits->cnt = cnt;
+    edits->text = text;
+    return 1;
+}
+
+// Fold a same-key interval into the average and derive the timeout from it, within the bounds
+static void t9_core_adapt_sample(t9_core_t *core, uint32_t interval)
+{
+    if (interval > core->adapt_max_ms)
+        interval = core->adapt_max_ms;
+    core->tap_avg_x8 = core->tap_avg_x8 - (core->tap_avg_x8 >> T9_ADAPT_SHIFT) + interval;
+    uint32_t timeout = ((core->tap_avg_x8 >> T9_ADAPT_SHIFT) * T9_ADAPT_MARGIN_PCT) / 100;
+    if (timeout < core->adapt_min_ms)
+        timeout = core->adapt_min_ms;
+    if (timeout > core->adapt_max_ms)
+        timeout = core->adapt_max_ms;
+    core->adapt_timeout_ms = (uint16_t)timeout;
+}
+
+void t9_core_init(t9_core_t *core, const t9_charset_t *charset, uint32_t timeout_ms)
+{
+    if (core == NULL)
+        return;
+    *core = (t9_core_t){0};
+    core->charset = charset ? charset : &lv_keyboard_t9_charset_default;
+    core->timeout_ms = timeout_ms;
+    core->last_key = -1;
+    core->mode = T9_MODE_LOWER;
+}
+
+void t9_core_end_cycle(t9_core_t *core)
+{
+    core->last_key = -1;
+    core->adapt_miss = 0; // A backspace after this is no correction of the last tap
+}
+
+void t9_core_set_mode(t9_core_t *core, t9_mode_t mode)
+{
+    core->mode = (uint8_t)mode;
+    core->shift = T9_SHIFT_OFF; // Set again by the shift key after the switch
+}
+
+void t9_core_set_charset(t9_core_t *core, const t9_charset_t *charset)
+{
+    core->charset = charset ? charset : &lv_keyboard_t9_charset_default;
+    core->last_key = -1; // The cycle index belongs to the previous pack
+}
+
+void t9_core_set_timeout(t9_core_t *core, uint32_t ms)
+{
+    core->timeout_ms = ms;
+}
+
+uint32_t t9_core_get_timeout(const t9_core_t *core)
+{
+    return core->adapt_max_ms ? core->adapt_timeout_ms : core->timeout_ms;
+}
+
+bool t9_core_set_adaptive_timeout(t9_core_t *core, uint32_t min_ms, uint32_t max_ms)
+{
+    if (max_ms == 0)
+    {
+        core->adapt_max_ms = 0;
+        return true;
+    }
+    if (min_ms == 0 || min_ms > max_ms || max_ms > UINT16_MAX)
+        return false;
+    core->adapt_min_ms = (uint16_t)min_ms;
+    core->adapt_max_ms = (uint16_t)max_ms;
+    core->adapt_miss = 0;
+    // Average that gives timeout_ms, then clamped like every later one
+    uint32_t start = core->timeout_ms < min_ms ? min_ms : core->timeout_ms > max_ms ? max_ms : core->timeout_ms;
+    core->tap_avg_x8 = ((start * 100) / T9_ADAPT_MARGIN_PCT) << T9_ADAPT_SHIFT;
+    core->adapt_timeout_ms = (uint16_t)start;
+    return true;
+}
+
+// Helper keys close the char being cycled, and the one-shot shift once its char is typed
+static uint32_t t9_core_press_helper(t9_core_t *core, uint32_t key, t9_edit_t *edits, uint32_t max)
+{
+    core->last_key = -1;
+    if (core->shift == T9_SHIFT_USED)
+        t9_core_set_mode(core, T9_MODE_LOWER); // The shifted char is done
+    switch (key)
+    {
+    case T9_CORE_KEY_BACKSPACE:
+        return t9_core_emit(edits, max, T9_EDIT_DELETE, false, 1, NULL);
+    case T9_CORE_KEY_SPACE:
+        return t9_core_emit(edits, max, T9_EDIT_INSERT, false, 0, " ");
+    case T9_CORE_KEY_MODE:
+        // Letters -> Predictive (if enabled) -> Numbers -> Letters
+        if (core->mode == T9_MODE_NUMBERS)
+            t9_core_set_mode(core, T9_MODE_LOWER);
+        else if (core->mode != T9_MODE_PREDICTIVE && core->predictive)
+            t9_core_set_mode(core, T9_MODE_PREDICTIVE);
+        else
+            t9_core_set_mode(core, T9_MODE_NUMBERS);
+        return 0;
+    case T9_CORE_KEY_CASE:
+        t9_core_set_mode(core, core->mode == T9_MODE_LOWER ? T9_MODE_UPPER : T9_MODE_LOWER);
+        return 0;
+    case T9_CORE_KEY_SHIFT:
+        // Lower -> one-shot upper -> caps lock (shift again before typing) -> lower
+        if (core->mode == T9_MODE_LOWER)
+        {
+            t9_core_set_mode(core, T9_MODE_UPPER);
+            core->shift = T9_SHIFT_ONCE;
+        }
+        else if (core->mode == T9_MODE_UPPER)
+        {
+            if (core->shift == T9_SHIFT_ONCE)
+                core->shift = T9_SHIFT_OFF;
+            else
+                t9_core_set_mode(core, T9_MODE_LOWER);
+        }
+        return 0;
+    default:
+        return 0; // OK, close
+    }
+}
+
+uint32_t t9_core_press(t9_core_t *core, uint32_t key, uint32_t now, t9_edit_t *edits, uint32_t max)
+{
+    if (core == NULL || key >= T9_CORE_KEY_COUNT)
+        return 0;
+
+    // A backspace right after a late same-key tap corrects it: that interval was meant to cycle
+    uint16_t adapt_miss = core->adapt_miss;
+    core->adapt_miss = 0;
+    if (key == T9_CORE_KEY_BACKSPACE && adapt_miss && core->adapt_max_ms)
+        t9_core_adapt_sample(core, adapt_miss);
+
+    if (key >= T9_CORE_CHAR_KEYS)
+        return t9_core_press_helper(core, key, edits, max);
+
+    // Numbers do not cycle
+    if (core->mode == T9_MODE_NUMBERS)
+        return t9_core_emit(edits, max, T9_EDIT_INSERT, false, 0, t9_core_digits[key]);
+
+    // A new char unless the same key comes again within the timeout
+    uint32_t interval = now - core->last_press_time;
+    bool same_key = (int32_t)key == core->last_key;
+    bool cycling = same_key && interval <= t9_core_get_timeout(core);
+    if (core->shift == T9_SHIFT_USED && !cycling)
+        t9_core_set_mode(core, T9_MODE_LOWER); // The shifted char is done, this one is lower case
+
+    // Chars of the key in the charset pack
+    const t9_charset_t *cs = core->charset;
+    uint32_t idx = (core->mode == T9_MODE_UPPER ? T9_CORE_CHAR_KEYS : 0) + key;
+    uint32_t first = cs->key_first[idx];
+    uint32_t count = cs->key_first[idx + 1] - first;
+    if (count == 0)
+        return 0;
+    if (core->shift == T9_SHIFT_ONCE)
+        core->shift = T9_SHIFT_USED; // Cycles in upper case until the next char
+    if (core->adapt_max_ms && same_key)
+    {
+        if (cycling)
+            t9_core_adapt_sample(core, interval);
+        else if (interval < core->adapt_max_ms)
+            core->adapt_miss = (uint16_t)(interval ? interval : 1);
+    }
+    if (!cycling)
+    {
+        core->cycle_idx = 0;
+    }
+    else
+    {
+        core->cycle_idx++;
+        if (core->cycle_idx >= count)
+            core->cycle_idx = 0;
+    }
+    core->last_key = (int8_t)key;
+    core->last_press_time = now;
+    const char *out = &cs->blob[cs->offs[first + core->cycle_idx]];
+    return t9_core_emit(edits, max, cycling ? T9_EDIT_REPLACE_LAST : T9_EDIT_INSERT, true, 0, out);
+}
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Generate T9 keyboard charset packs (t9_charset_t) as flash-resident C tables.
+
+Every character of a pack is stored once, NUL terminated, in a single UTF-8 blob. The
+per-character byte offsets and the per-key first character index are precomputed, so the
+keyboard cycles and builds popovers with array lookups only.
+
+Usage:
+    python3 tools/t9_charset_gen.py > src/lv_keyboard_t9_charset.c      # built-in packs
+    python3 tools/t9_charset_gen.py my_pack.json > my_pack.c            # custom pack(s)
+
+A JSON pack looks like:
+    {"name": "greek",
+     "lower": ["1...", "αβγ2", ... 10 strings, one per key '1'..'9','0'],
+     "upper": [... 10 strings ...],
+     "labels_lower": [... optional 10 key labels ...],
+     "labels_upper": [... optional 10 key labels ...]}
+"""
+import json
+import sys
+
+KEY_COUNT = 10
+POPOVER_COLS = 4
+POPOVER_PAGE_THRESHOLD = 20  # T9_POPOVER_PAGE_THRESHOLD: larger keys get no map, the keyboard pages them
+
+SYMBOLS_1 = "1:;<=>?@[\\]^_`{|}~"
+SYMBOLS_0 = "0!\"#$%&'()*+,-./"
+
+BUILTIN = [
+    {
+        "name": "default",
+        "comment": "ASCII letters, the keyboard default",
+        "lower": [SYMBOLS_1, "abc2", "def3", "ghi4", "jkl5", "mno6", "pqrs7", "tuv8", "wxyz9", SYMBOLS_0],
+        "upper": [SYMBOLS_1, "ABC2", "DEF3", "GHI4", "JKL5", "MNO6", "PQRS7", "TUV8", "WXYZ9", SYMBOLS_0],
+    },
+    {
+        "name": "latin",
+        "comment": "ASCII letters plus Portuguese / Spanish accented letters",
+        "lower": [SYMBOLS_1, "abcáàâãç2", "deféê3", "ghií4", "jkl5", "mnoñóôõ6", "pqrs7", "tuvúü8", "wxyz9", SYMBOLS_0],
+        "upper": [SYMBOLS_1, "ABCÁÀÂÃÇ2", "DEFÉÊ3", "GHIÍ4", "JKL5", "MNOÑÓÔÕ6", "PQRS7", "TUVÚÜ8", "WXYZ9", SYMBOLS_0],
+    },
+]
+
+
+def c_str(text):
+    """C string literal, split after hex escapes so they never swallow the next char."""
+    parts = []
+    cur = ""
+    for ch in text:
+        if ch == "\\":
+            cur += "\\\\"
+        elif ch == '"':
+            cur += '\\"'
+        elif 32 <= ord(ch) < 127:
+            cur += ch
+        else:
+            cur += "".join("\\x%02x" % b for b in ch.encode("utf-8"))
+            # Only the last byte can be followed by a char that continues the escape
+            parts.append(cur)
+            cur = ""
+    if cur or not parts:
+        parts.append(cur)
+    return " ".join('"%s"' % part for part in parts)
+
+
+def default_label(chars):
+    """Key label like the built-in maps: "abc2" for letter keys, "1:;..." for symbol keys."""
+    if not chars[0].isalpha():
+        return chars[:3] + "..." if len(chars) > 4 else chars
+    letters = [ch for ch in chars if ch.isalpha()]
+    ascii_letters = [ch for ch in letters if ord(ch) < 128]
+    label = "".join((ascii_letters or letters)[:4])
+    return label + chars[-1] if chars[-1].isdigit() else label
+
+
+def gen_pack(pack):
+    name = pack["name"]
+    cases = [pack["lower"], pack["upper"]]
+    for keys in cases:
+        if len(keys) != KEY_COUNT:
+            raise ValueError("%s: expected %d keys, got %d" % (name, KEY_COUNT, len(keys)))
+    labels = [pack.get("labels_lower") or [default_label(k) for k in cases[0]],
+              pack.get("labels_upper") or [default_label(k) for k in cases[1]]]
+
+    # Blob with every distinct char once, offs/key_first referencing it
+    blob = []
+    blob_pos = {}
+    blob_len = 0
+    offs = []
+    key_first = []
+    for keys in cases:
+        for chars in keys:
+            key_first.append(len(offs))
+            for ch in chars:
+                if ch not in blob_pos:
+                    blob_pos[ch] = blob_len
+                    blob.append(ch)
+                    blob_len += len(ch.encode("utf-8")) + 1
+                offs.append(blob_pos[ch])
+    key_first.append(len(offs))
+    if blob_len > 0xFFFF:
+        raise ValueError("%s: blob too large" % name)
+
+    out = []
+    out.append("// --- %s: %s ---" % (name, pack.get("comment", "generated pack")))
+    out.append("")
+    out.append("static const char t9_cs_%s_blob[] =" % name)
+    for i in range(0, len(blob), 8):
+        out.append("    " + " ".join(c_str(ch) + ' "\\0"' for ch in blob[i:i + 8]))
+    out.append("    ;")
+    out.append("")
+    out.append("static const uint16_t t9_cs_%s_offs[%d] = {" % (name, len(offs)))
+    for i in range(0, len(offs), 12):
+        out.append("    " + ", ".join(str(o) for o in offs[i:i + 12]) + ",")
+    out.append("};")
+    out.append("")
+
+    # Popover maps, POPOVER_COLS buttons per row, no trailing linebreak
+    for case_idx, keys in enumerate(cases):
+        for key, chars in enumerate(keys):
+            if len(chars) > POPOVER_PAGE_THRESHOLD:
+                continue
+            entries = []
+            for i, ch in enumerate(chars):
+                if i and i % POPOVER_COLS == 0:
+                    entries.append('"\\n"')
+                entries.append("t9_cs_%s_blob + %d" % (name, blob_pos[ch]))
+            entries.append("NULL")
+            out.append("static const char *const t9_cs_%s_pop_%d_%d[] = {" % (name, case_idx, key))
+            line = "   "
+            for ent in entries:
+                if len(line) + len(ent) > 110:
+                    out.append(line)
+                    line = "   "
+                line += " " + ent + ","
+            out.append(line.rstrip(","))
+            out.append("};")
+    out.append("")
+
+    out.append("const t9_charset_t lv_keyboard_t9_charset_%s = {" % name)
+    out.append("    .blob = t9_cs_%s_blob," % name)
+    out.append("    .offs = t9_cs_%s_offs," % name)
+    out.append("    .key_first = {" + ", ".join(str(k) for k in key_first) + "},")
+    out.append("    .labels = {")
+    for case_labels in labels:
+        out.append("        {" + ", ".join(c_str(label) for label in case_labels) + "},")
+    out.append("    },")
+    out.append("    .popover_maps = {")
+    for case_idx in range(2):
+        maps = ["t9_cs_%s_pop_%d_%d" % (name, case_idx, k) if len(cases[case_idx][k]) <= POPOVER_PAGE_THRESHOLD
+                else "NULL" for k in range(KEY_COUNT)]
+        out.append("        {" + ", ".join(maps) + "},")
+    out.append("    },")
+    out.append("};")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    if len(sys.argv) > 1:
+        packs = []
+        for path in sys.argv[1:]:
+            with open(path, encoding="utf-8") as f:
+                data = json.load(f)
+            packs.extend(data if isinstance(data, list) else [data])
+        header = "Charset packs generated by tools/t9_charset_gen.py from " + ", ".join(sys.argv[1:])
+    else:
+        packs = BUILTIN
+        header = "Built-in charset packs, generated by tools/t9_charset_gen.py (do not edit by hand)"
+
+    print("/**")
+    print(" * @file")
+    print(" * @brief %s." % header)
+    print(" */")
+    print('#include "t9_core.h"')
+    print("")
+    for pack in packs:
+        print(gen_pack(pack))
+
+
+if __name__ == "__main__":
+    main()
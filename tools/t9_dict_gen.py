@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Generate a packed T9 dictionary (lv_keyboard_t9_dict_open) from a word frequency list.
+
+The digit trie of the words is laid out breadth-first so the children of a node are
+consecutive and found with a digit bit mask, the exact matches of every node are ranked
+and the best word of every subtree is precomputed: the keyboard reads the image in place,
+from flash or a mapped file, without building anything in RAM. Words ending another word
+share its bytes in the string pool. The format is described in src/lv_keyboard_t9_private.h.
+
+Usage:
+    python3 tools/t9_dict_gen.py words.txt -o dict.bin             # partition / file image
+    python3 tools/t9_dict_gen.py words.txt --c-array t9_dict_en > t9_dict_en.c
+
+The input has one word per line, optionally followed by its frequency ("the 23135851").
+Without frequencies the list order is the rank (first is most frequent). Lines starting
+with '#' are comments, words with other chars than the ASCII letters are skipped.
+"""
+import argparse
+import struct
+import sys
+
+VERSION = 1
+HEADER_SIZE = 32
+INDEX_MAX = 0x00FFFFFF
+NO_WORD = 0xFFFFFFFF
+NODE_WORDS_MAX = 255  # Exact word count field, only the first T9_PRED_CANDIDATES are ever shown
+
+LETTER_DIGIT = {}
+for digit, letters in enumerate(["abc", "def", "ghi", "jkl", "mno", "pqrs", "tuv", "wxyz"], start=2):
+    for ch in letters:
+        LETTER_DIGIT[ch] = digit
+
+
+def read_words(path):
+    """(word, freq) pairs of the list, the first occurrence of a word keeps its position."""
+    entries = {}
+    order = 0
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            parts = line.split()
+            if not parts or parts[0].startswith("#"):
+                continue
+            word = parts[0]
+            if not word.isascii() or not word.isalpha():
+                print("skipping '%s'" % word, file=sys.stderr)
+                continue
+            freq = int(parts[1]) if len(parts) > 1 else None
+            if word in entries:
+                old_freq, old_order = entries[word]
+                if freq is not None and (old_freq is None or freq > old_freq):
+                    entries[word] = (freq, old_order)
+                continue
+            entries[word] = (freq, order)
+            order += 1
+    # Best first: higher frequency, then list order
+    return sorted(entries, key=lambda w: (-(entries[w][0] or 0), entries[w][1]))
+
+
+class Node:
+    __slots__ = ("children", "words", "best", "index")
+
+    def __init__(self):
+        self.children = {}
+        self.words = []  # Ranks of the exact matches, best first
+        self.best = None
+        self.index = 0
+
+
+def build_trie(ranked):
+    root = Node()
+    for rank, word in enumerate(ranked):
+        node = root
+        for ch in word.lower():
+            node = node.children.setdefault(LETTER_DIGIT[ch], Node())
+            if node.best is None:
+                node.best = rank  # Words come best first
+        if len(node.words) < NODE_WORDS_MAX:
+            node.words.append(rank)
+    return root
+
+
+def build_strings(ranked):
+    """String pool offsets of the words, a word that ends the previous pool string points into it."""
+    offsets = {}
+    pool = bytearray()
+    last = None
+    last_off = 0
+    for word in sorted(set(ranked), key=lambda w: w[::-1], reverse=True):
+        data = word.encode("ascii")
+        if last is not None and last.endswith(data):
+            offsets[word] = last_off + len(last) - len(data)
+            continue
+        last = data
+        last_off = len(pool)
+        offsets[word] = last_off
+        pool += data + b"\0"
+    return offsets, bytes(pool)
+
+
+def pack(ranked):
+    root = build_trie(ranked)
+    offsets, pool = build_strings(ranked)
+
+    # Breadth-first: the children of every node get consecutive indices, sorted by digit
+    order = [root]
+    i = 0
+    while i < len(order):
+        node = order[i]
+        for digit in sorted(node.children):
+            child = node.children[digit]
+            child.index = len(order)
+            order.append(child)
+        i += 1
+    if len(order) > INDEX_MAX or len(ranked) > INDEX_MAX:
+        sys.exit("dictionary too large: %d nodes, %d words" % (len(order), len(ranked)))
+
+    nodes = bytearray()
+    word_table = bytearray()
+    word_count = 0
+    for node in order:
+        mask = 0
+        first_child = 0
+        if node.children:
+            first_child = min(c.index for c in node.children.values())
+            for digit in node.children:
+                mask |= 1 << (digit - 2)
+        best = offsets[ranked[node.best]] if node.best is not None else NO_WORD
+        nodes += struct.pack("<III", first_child | (mask << 24), word_count | (len(node.words) << 24), best)
+        for rank in node.words:
+            word_table += struct.pack("<I", offsets[ranked[rank]])
+        word_count += len(node.words)
+
+    nodes_off = HEADER_SIZE
+    words_off = nodes_off + len(nodes)
+    strings_off = words_off + len(word_table)
+    total = strings_off + len(pool)
+    total += -total % 4
+    header = b"T9D" + bytes([VERSION]) + struct.pack(
+        "<7I", len(order), word_count, len(pool), nodes_off, words_off, strings_off, total)
+    image = header + nodes + word_table + pool
+    image += b"\0" * (total - len(image))
+    return image, len(order), word_count
+
+
+def c_array(name, image):
+    words = struct.unpack("<%dI" % (len(image) // 4), image)
+    out = ["// Generated by tools/t9_dict_gen.py, open with lv_keyboard_t9_dict_open(%s, %s_size)" % (name, name),
+           "#include <stdint.h>",
+           "",
+           "// uint32_t for the 4-byte alignment of the packed sections (little-endian targets)",
+           "const uint32_t %s[%d] = {" % (name, len(words))]
+    for i in range(0, len(words), 8):
+        out.append("    " + ", ".join("0x%08x" % w for w in words[i:i + 8]) + ",")
+    out.append("};")
+    out.append("const uint32_t %s_size = %d;" % (name, len(image)))
+    return "\n".join(out) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1],
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("words", help="word list, one word per line with an optional frequency")
+    parser.add_argument("-o", "--output", help="binary image to write (partition or file)")
+    parser.add_argument("--c-array", metavar="NAME", help="print a C array named NAME instead")
+    args = parser.parse_args()
+    if not args.output and not args.c_array:
+        parser.error("give -o or --c-array")
+
+    ranked = read_words(args.words)
+    if not ranked:
+        sys.exit("no word to pack")
+    image, node_count, word_count = pack(ranked)
+    print("%d words, %d nodes, %d bytes" % (word_count, node_count, len(image)), file=sys.stderr)
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(image)
+    if args.c_array:
+        sys.stdout.write(c_array(args.c_array, image))
+
+
+if __name__ == "__main__":
+    main()